@@ -822,6 +822,16 @@ int nvgCreateImageRGBA(NVGcontext* ctx, int w, int h, int imageFlags, const unsi
 	return ctx->params.renderCreateTexture(ctx->params.userPtr, NVG_TEXTURE_RGBA, w, h, imageFlags, data);
 }
 
+int nvgCreateImageLevels(NVGcontext* ctx, int type, int w, int h, int imageFlags, const unsigned char* const* levels, int nlevels)
+{
+	if (nlevels < 1) return 0;
+	if (ctx->params.renderCreateTextureLevels != NULL)
+		return ctx->params.renderCreateTextureLevels(ctx->params.userPtr, type, w, h, imageFlags, levels, nlevels);
+	if (nlevels > 1)
+		imageFlags |= NVG_IMAGE_GENERATE_MIPMAPS;
+	return ctx->params.renderCreateTexture(ctx->params.userPtr, type, w, h, imageFlags, levels[0]);
+}
+
 void nvgUpdateImage(NVGcontext* ctx, int image, const unsigned char* data)
 {
 	int w, h;
@@ -829,11 +839,23 @@ void nvgUpdateImage(NVGcontext* ctx, int image, const unsigned char* data)
 	ctx->params.renderUpdateTexture(ctx->params.userPtr, image, 0,0, w,h, data);
 }
 
+int nvgUpdateImageRegion(NVGcontext* ctx, int image, int x, int y, int w, int h, int stride, const unsigned char* data)
+{
+	if (ctx->params.renderUpdateTextureRegion == NULL) return 0;
+	return ctx->params.renderUpdateTextureRegion(ctx->params.userPtr, image, x, y, w, h, stride, data);
+}
+
 void nvgImageSize(NVGcontext* ctx, int image, int* w, int* h)
 {
 	ctx->params.renderGetTextureSize(ctx->params.userPtr, image, w, h);
 }
 
+int nvgImageFormat(NVGcontext* ctx, int image, int* type, int* imageFlags)
+{
+	if (ctx->params.renderGetTextureFormat == NULL) return 0;
+	return ctx->params.renderGetTextureFormat(ctx->params.userPtr, image, type, imageFlags);
+}
+
 void nvgDeleteImage(NVGcontext* ctx, int image)
 {
 	ctx->params.renderDeleteTexture(ctx->params.userPtr, image);
@@ -1123,6 +1145,23 @@ static void nvg__appendCommands(NVGcontext* ctx, float* vals, int nvals)
 	ctx->ncommands += nvals;
 }
 
+// Grows the command buffer by nvals and returns the space for the new commands, which
+// the caller fills with commands that are already transformed
+static float* nvg__reserveCommands(NVGcontext* ctx, int nvals)
+{
+	float* vals;
+	if (ctx->ncommands+nvals > ctx->ccommands) {
+		float* commands;
+		int ccommands = ctx->ncommands+nvals + ctx->ccommands/2;
+		commands = (float*)realloc(ctx->commands, sizeof(float)*ccommands);
+		if (commands == NULL) return NULL;
+		ctx->commands = commands;
+		ctx->ccommands = ccommands;
+	}
+	vals = &ctx->commands[ctx->ncommands];
+	ctx->ncommands += nvals;
+	return vals;
+}
 
 static void nvg__clearPathCache(NVGcontext* ctx)
 {
@@ -2194,6 +2233,97 @@ void nvgCircle(NVGcontext* ctx, float cx, float cy, float r)
 	nvgEllipse(ctx, cx,cy, r,r);
 }
 
+void nvgRects(NVGcontext* ctx, const float* rects, int count)
+{
+	NVGstate* state = nvg__getState(ctx);
+	const float* t = state->xform;
+	float* vals;
+	int i;
+
+	if (count <= 0) return;
+	vals = nvg__reserveCommands(ctx, count*13);
+	if (vals == NULL) return;
+
+	for (i = 0; i < count; i++) {
+		const float* r = &rects[i*4];
+		float* v = &vals[i*13];
+		float x0 = r[0]*t[0] + r[1]*t[2] + t[4], y0 = r[0]*t[1] + r[1]*t[3] + t[5];
+		float wx = r[2]*t[0], wy = r[2]*t[1], hx = r[3]*t[2], hy = r[3]*t[3];
+		v[0] = NVG_MOVETO; v[1] = x0; v[2] = y0;
+		v[3] = NVG_LINETO; v[4] = x0+hx; v[5] = y0+hy;
+		v[6] = NVG_LINETO; v[7] = x0+wx+hx; v[8] = y0+wy+hy;
+		v[9] = NVG_LINETO; v[10] = x0+wx; v[11] = y0+wy;
+		v[12] = NVG_CLOSE;
+	}
+	ctx->commandx = rects[(count-1)*4] + rects[(count-1)*4+2];
+	ctx->commandy = rects[(count-1)*4+1];
+}
+
+void nvgCircles(NVGcontext* ctx, const float* circles, int count)
+{
+	// The same four bezier segments as nvgEllipse, as offsets from the center
+	static const float shape[] = {
+		-1,0, -1,NVG_KAPPA90, -NVG_KAPPA90,1, 0,1,
+		NVG_KAPPA90,1, 1,NVG_KAPPA90, 1,0,
+		1,-NVG_KAPPA90, NVG_KAPPA90,-1, 0,-1,
+		-NVG_KAPPA90,-1, -1,-NVG_KAPPA90, -1,0
+	};
+	NVGstate* state = nvg__getState(ctx);
+	const float* t = state->xform;
+	float* vals;
+	int i, j;
+
+	if (count <= 0) return;
+	vals = nvg__reserveCommands(ctx, count*32);
+	if (vals == NULL) return;
+
+	for (i = 0; i < count; i++) {
+		const float* c = &circles[i*3];
+		float* v = &vals[i*32];
+		float cx = c[0]*t[0] + c[1]*t[2] + t[4], cy = c[0]*t[1] + c[1]*t[3] + t[5];
+		float ax = c[2]*t[0], ay = c[2]*t[1], bx = c[2]*t[2], by = c[2]*t[3];
+		v[0] = NVG_MOVETO;
+		v[1] = cx + shape[0]*ax + shape[1]*bx;
+		v[2] = cy + shape[0]*ay + shape[1]*by;
+		for (j = 0; j < 4; j++) {
+			const float* p = &shape[2 + j*6];
+			float* b = &v[3 + j*7];
+			b[0] = NVG_BEZIERTO;
+			b[1] = cx + p[0]*ax + p[1]*bx; b[2] = cy + p[0]*ay + p[1]*by;
+			b[3] = cx + p[2]*ax + p[3]*bx; b[4] = cy + p[2]*ay + p[3]*by;
+			b[5] = cx + p[4]*ax + p[5]*bx; b[6] = cy + p[4]*ay + p[5]*by;
+		}
+		v[31] = NVG_CLOSE;
+	}
+	ctx->commandx = circles[(count-1)*3] - circles[(count-1)*3+2];
+	ctx->commandy = circles[(count-1)*3+1];
+}
+
+void nvgLineSegments(NVGcontext* ctx, const float* points, int count)
+{
+	NVGstate* state = nvg__getState(ctx);
+	const float* t = state->xform;
+	float* vals;
+	int i;
+
+	if (count <= 0) return;
+	vals = nvg__reserveCommands(ctx, count*6);
+	if (vals == NULL) return;
+
+	for (i = 0; i < count; i++) {
+		const float* p = &points[i*4];
+		float* v = &vals[i*6];
+		v[0] = NVG_MOVETO;
+		v[1] = p[0]*t[0] + p[1]*t[2] + t[4];
+		v[2] = p[0]*t[1] + p[1]*t[3] + t[5];
+		v[3] = NVG_LINETO;
+		v[4] = p[2]*t[0] + p[3]*t[2] + t[4];
+		v[5] = p[2]*t[1] + p[3]*t[3] + t[5];
+	}
+	ctx->commandx = points[(count-1)*4+2];
+	ctx->commandy = points[(count-1)*4+3];
+}
+
 void nvgDebugDumpPathCache(NVGcontext* ctx)
 {
 	const NVGpath* path;
@@ -2245,24 +2375,34 @@ void nvgFill(NVGcontext* ctx)
 	}
 }
 
-void nvgStroke(NVGcontext* ctx)
+static float nvg__strokeWidth(NVGcontext* ctx, float* coverage)
 {
 	NVGstate* state = nvg__getState(ctx);
 	float scale = nvg__getAverageScale(state->xform);
 	float strokeWidth = nvg__clampf(state->strokeWidth * scale, 0.0f, 200.0f);
-	NVGpaint strokePaint = state->stroke;
-	const NVGpath* path;
-	int i;
-
 
+	*coverage = 1.0f;
 	if (strokeWidth < ctx->fringeWidth) {
 		// If the stroke width is less than pixel size, use alpha to emulate coverage.
 		// Since coverage is area, scale by alpha*alpha.
 		float alpha = nvg__clampf(strokeWidth / ctx->fringeWidth, 0.0f, 1.0f);
-		strokePaint.innerColor.a *= alpha*alpha;
-		strokePaint.outerColor.a *= alpha*alpha;
+		*coverage = alpha*alpha;
 		strokeWidth = ctx->fringeWidth;
 	}
+	return strokeWidth;
+}
+
+void nvgStroke(NVGcontext* ctx)
+{
+	NVGstate* state = nvg__getState(ctx);
+	float coverage;
+	float strokeWidth = nvg__strokeWidth(ctx, &coverage);
+	NVGpaint strokePaint = state->stroke;
+	const NVGpath* path;
+	int i;
+
+	strokePaint.innerColor.a *= coverage;
+	strokePaint.outerColor.a *= coverage;
 
 	// Apply global alpha
 	strokePaint.innerColor.a *= state->alpha;
@@ -2286,6 +2426,278 @@ void nvgStroke(NVGcontext* ctx)
 	}
 }
 
+struct NVGgeometry {
+	NVGpath* paths;
+	NVGpath* drawPaths;
+	int npaths;
+	NVGvertex* verts;
+	int nverts;
+	float bounds[4];
+	int stroke;
+	float strokeWidth;
+	float coverage;
+	float fringeWidth;
+};
+
+static NVGgeometry* nvg__createGeometry(NVGcontext* ctx, int stroke, float strokeWidth, float coverage)
+{
+	NVGpathCache* cache = ctx->cache;
+	NVGgeometry* geometry;
+	NVGvertex* dst;
+	int i, nverts = 0;
+
+	for (i = 0; i < cache->npaths; i++)
+		nverts += cache->paths[i].nfill + cache->paths[i].nstroke;
+
+	geometry = (NVGgeometry*)malloc(sizeof(NVGgeometry));
+	if (geometry == NULL) return NULL;
+	memset(geometry, 0, sizeof(NVGgeometry));
+
+	geometry->paths = (NVGpath*)malloc(sizeof(NVGpath)*nvg__maxi(cache->npaths, 1));
+	geometry->drawPaths = (NVGpath*)malloc(sizeof(NVGpath)*nvg__maxi(cache->npaths, 1));
+	geometry->verts = (NVGvertex*)malloc(sizeof(NVGvertex)*nvg__maxi(nverts, 1));
+	if (geometry->paths == NULL || geometry->drawPaths == NULL || geometry->verts == NULL) {
+		nvgDeleteGeometry(geometry);
+		return NULL;
+	}
+
+	// Copy the vertices out of the path cache, which is reused by the next path
+	dst = geometry->verts;
+	for (i = 0; i < cache->npaths; i++) {
+		NVGpath* path = &geometry->paths[i];
+		*path = cache->paths[i];
+		if (path->nfill > 0) {
+			memcpy(dst, path->fill, sizeof(NVGvertex)*path->nfill);
+			path->fill = dst;
+			dst += path->nfill;
+		}
+		if (path->nstroke > 0) {
+			memcpy(dst, path->stroke, sizeof(NVGvertex)*path->nstroke);
+			path->stroke = dst;
+			dst += path->nstroke;
+		}
+	}
+	geometry->npaths = cache->npaths;
+	geometry->nverts = nverts;
+	memcpy(geometry->bounds, cache->bounds, sizeof(float)*4);
+	geometry->stroke = stroke;
+	geometry->strokeWidth = strokeWidth;
+	geometry->coverage = coverage;
+	geometry->fringeWidth = ctx->fringeWidth;
+
+	return geometry;
+}
+
+NVGgeometry* nvgCreateFillGeometry(NVGcontext* ctx)
+{
+	NVGstate* state = nvg__getState(ctx);
+
+	nvg__flattenPaths(ctx);
+	if (ctx->params.edgeAntiAlias && state->shapeAntiAlias)
+		nvg__expandFill(ctx, ctx->fringeWidth, NVG_MITER, 2.4f);
+	else
+		nvg__expandFill(ctx, 0.0f, NVG_MITER, 2.4f);
+
+	return nvg__createGeometry(ctx, 0, 0.0f, 1.0f);
+}
+
+NVGgeometry* nvgCreateStrokeGeometry(NVGcontext* ctx)
+{
+	NVGstate* state = nvg__getState(ctx);
+	float coverage;
+	float strokeWidth = nvg__strokeWidth(ctx, &coverage);
+
+	nvg__flattenPaths(ctx);
+	if (ctx->params.edgeAntiAlias && state->shapeAntiAlias)
+		nvg__expandStroke(ctx, strokeWidth*0.5f, ctx->fringeWidth, state->lineCap, state->lineJoin, state->miterLimit);
+	else
+		nvg__expandStroke(ctx, strokeWidth*0.5f, 0.0f, state->lineCap, state->lineJoin, state->miterLimit);
+
+	return nvg__createGeometry(ctx, 1, strokeWidth, coverage);
+}
+
+void nvgDrawGeometry(NVGcontext* ctx, NVGgeometry* geometry, const float* xform)
+{
+	NVGstate* state = nvg__getState(ctx);
+	NVGpaint paint = geometry->stroke ? state->stroke : state->fill;
+	float scale = nvg__getAverageScale((float*)xform);
+	float bounds[4] = {1e6f, 1e6f, -1e6f, -1e6f};
+	NVGvertex* verts;
+	const NVGvertex* src;
+	int i, j;
+
+	if (geometry->npaths == 0) return;
+
+	verts = nvg__allocTempVerts(ctx, geometry->nverts);
+	if (verts == NULL) return;
+
+	for (i = 0; i < geometry->nverts; i++) {
+		src = &geometry->verts[i];
+		verts[i].x = src->x*xform[0] + src->y*xform[2] + xform[4];
+		verts[i].y = src->x*xform[1] + src->y*xform[3] + xform[5];
+		verts[i].u = src->u;
+		verts[i].v = src->v;
+	}
+	for (i = 0; i < geometry->npaths; i++) {
+		NVGpath* path = &geometry->drawPaths[i];
+		*path = geometry->paths[i];
+		if (path->nfill > 0)
+			path->fill = verts + (path->fill - geometry->verts);
+		if (path->nstroke > 0)
+			path->stroke = verts + (path->stroke - geometry->verts);
+	}
+	for (i = 0; i < 4; i++) {
+		float x, y;
+		nvgTransformPoint(&x, &y, xform, geometry->bounds[(i & 1) * 2], geometry->bounds[(i >> 1) * 2 + 1]);
+		bounds[0] = nvg__minf(bounds[0], x);
+		bounds[1] = nvg__minf(bounds[1], y);
+		bounds[2] = nvg__maxf(bounds[2], x);
+		bounds[3] = nvg__maxf(bounds[3], y);
+	}
+
+	// Apply stroke coverage and global alpha
+	paint.innerColor.a *= geometry->coverage * state->alpha;
+	paint.outerColor.a *= geometry->coverage * state->alpha;
+
+	if (geometry->stroke) {
+		ctx->params.renderStroke(ctx->params.userPtr, &paint, state->compositeOperation, &state->scissor,
+								 geometry->fringeWidth*scale, geometry->strokeWidth*scale,
+								 geometry->drawPaths, geometry->npaths);
+		for (j = 0; j < geometry->npaths; j++) {
+			ctx->strokeTriCount += geometry->paths[j].nstroke-2;
+			ctx->drawCallCount++;
+		}
+	} else {
+		ctx->params.renderFill(ctx->params.userPtr, &paint, state->compositeOperation, &state->scissor,
+							   geometry->fringeWidth*scale, bounds, geometry->drawPaths, geometry->npaths);
+		for (j = 0; j < geometry->npaths; j++) {
+			ctx->fillTriCount += geometry->paths[j].nfill-2;
+			ctx->fillTriCount += geometry->paths[j].nstroke-2;
+			ctx->drawCallCount += 2;
+		}
+	}
+}
+
+static NVGcolor nvg__mulColor(NVGcolor a, NVGcolor b)
+{
+	a.r *= b.r;
+	a.g *= b.g;
+	a.b *= b.b;
+	a.a *= b.a;
+	return a;
+}
+
+void nvgDrawInstances(NVGcontext* ctx, NVGgeometry* geometry, const float* xforms, const NVGcolor* colors, int ncolors, int count)
+{
+	NVGstate* state = nvg__getState(ctx);
+	NVGpaint* target = geometry->stroke ? &state->stroke : &state->fill;
+	NVGpaint paint = *target;
+	int i;
+
+	if (geometry->npaths == 0 || count <= 0) return;
+	// Without a color for every instance there is no color to pick for the later ones
+	if (ncolors < 0 || (ncolors > 1 && ncolors < count)) return;
+
+	// A single convex fill is drawn by the back-end, which transforms the vertices on the GPU
+	if (ctx->params.renderInstances != NULL && !geometry->stroke && geometry->npaths == 1 && geometry->paths[0].convex) {
+		paint.innerColor.a *= state->alpha;
+		paint.outerColor.a *= state->alpha;
+		if (ctx->params.renderInstances(ctx->params.userPtr, &paint, state->compositeOperation, &state->scissor,
+										geometry->fringeWidth, geometry->paths, geometry->npaths,
+										xforms, colors, ncolors, count)) {
+			ctx->fillTriCount += (geometry->paths[0].nfill-2 + geometry->paths[0].nstroke-2) * count;
+			ctx->drawCallCount += 2;
+			return;
+		}
+		paint = *target;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (ncolors > 0) {
+			NVGcolor color = colors[ncolors == 1 ? 0 : i];
+			target->innerColor = nvg__mulColor(paint.innerColor, color);
+			target->outerColor = nvg__mulColor(paint.outerColor, color);
+		}
+		nvgDrawGeometry(ctx, geometry, &xforms[i*6]);
+	}
+	*target = paint;
+}
+
+void nvgDrawTriangles(NVGcontext* ctx, int image, NVGcolor color, const struct NVGvertex* verts, int nverts)
+{
+	NVGstate* state = nvg__getState(ctx);
+	NVGpaint paint;
+	NVGvertex* dst;
+	int i;
+
+	if (nverts < 3) return;
+
+	dst = nvg__allocTempVerts(ctx, nverts);
+	if (dst == NULL) return;
+
+	for (i = 0; i < nverts; i++) {
+		nvgTransformPoint(&dst[i].x, &dst[i].y, state->xform, verts[i].x, verts[i].y);
+		dst[i].u = verts[i].u;
+		dst[i].v = verts[i].v;
+	}
+	// Back faces are culled, so turn triangles that are wound the other way, or mirrored
+	// by the transform
+	for (i = 0; i+2 < nverts; i += 3) {
+		if (nvg__triarea2(dst[i].x, dst[i].y, dst[i+1].x, dst[i+1].y, dst[i+2].x, dst[i+2].y) < 0.0f) {
+			NVGvertex tmp = dst[i+1];
+			dst[i+1] = dst[i+2];
+			dst[i+2] = tmp;
+		}
+	}
+
+	memset(&paint, 0, sizeof(paint));
+	nvgTransformIdentity(paint.xform);
+	paint.image = image;
+	paint.innerColor = paint.outerColor = color;
+
+	// Apply global alpha
+	paint.innerColor.a *= state->alpha;
+	paint.outerColor.a *= state->alpha;
+
+	ctx->params.renderTriangles(ctx->params.userPtr, &paint, state->compositeOperation, &state->scissor, dst, nverts);
+
+	ctx->drawCallCount++;
+	ctx->fillTriCount += nverts/3;
+}
+
+int nvgGeometryVertexCount(const NVGgeometry* geometry)
+{
+	return geometry->nverts;
+}
+
+void nvgDeleteGeometry(NVGgeometry* geometry)
+{
+	if (geometry == NULL) return;
+	free(geometry->paths);
+	free(geometry->drawPaths);
+	free(geometry->verts);
+	free(geometry);
+}
+
+void nvgCurrentStrokeStyle(NVGcontext* ctx, float* width, float* miterLimit, int* lineCap, int* lineJoin)
+{
+	NVGstate* state = nvg__getState(ctx);
+	*width = state->strokeWidth;
+	*miterLimit = state->miterLimit;
+	*lineCap = state->lineCap;
+	*lineJoin = state->lineJoin;
+}
+
+int nvgCurrentAntiAlias(NVGcontext* ctx)
+{
+	return ctx->params.edgeAntiAlias && nvg__getState(ctx)->shapeAntiAlias;
+}
+
+float nvgDevicePixelRatio(NVGcontext* ctx)
+{
+	return ctx->devicePxRatio;
+}
+
 // Add fonts
 int nvgCreateFont(NVGcontext* ctx, const char* name, const char* path)
 {
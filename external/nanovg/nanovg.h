@@ -386,12 +386,29 @@ int nvgCreateImageMem(NVGcontext* ctx, int imageFlags, unsigned char* data, int
 //! Returns handle to the image.
 int nvgCreateImageRGBA(NVGcontext* ctx, int w, int h, int imageFlags, const unsigned char* data);
 
+//! Creates image from a chain of mip levels, level 0 being w x h and every next level half the
+//! size of the previous one, rounded down but at least 1. Type is NVG_TEXTURE_RGBA or
+//! NVG_TEXTURE_ALPHA. The levels are used instead of generated ones when the back-end supports
+//! it, otherwise mipmaps are generated from level 0 if more than one level is given.
+//! Returns handle to the image.
+int nvgCreateImageLevels(NVGcontext* ctx, int type, int w, int h, int imageFlags, const unsigned char* const* levels, int nlevels);
+
 //! Updates image data specified by image handle.
 void nvgUpdateImage(NVGcontext* ctx, int image, const unsigned char* data);
 
+//! Updates a w x h region of an image at x,y. Data points to the first pixel of the region,
+//! and stride is the number of pixels between the starts of two rows of data.
+//! Returns 0 if the image could not be updated.
+int nvgUpdateImageRegion(NVGcontext* ctx, int image, int x, int y, int w, int h, int stride, const unsigned char* data);
+
 //! Returns the dimensions of a created image.
 void nvgImageSize(NVGcontext* ctx, int image, int* w, int* h);
 
+//! Returns the texture type, NVG_TEXTURE_ALPHA or NVG_TEXTURE_RGBA, and the image flags of a
+//! created image. Images created with mip levels have NVG_IMAGE_GENERATE_MIPMAPS set.
+//! Returns 0 if the back-end does not know the image.
+int nvgImageFormat(NVGcontext* ctx, int image, int* type, int* imageFlags);
+
 //! Deletes created image.
 void nvgDeleteImage(NVGcontext* ctx, int image);
 
@@ -509,12 +526,74 @@ void nvgEllipse(NVGcontext* ctx, float cx, float cy, float rx, float ry);
 //! Creates new circle shaped sub-path.
 void nvgCircle(NVGcontext* ctx, float cx, float cy, float r);
 
+//! Creates one rectangle shaped sub-path for each of count rectangles, given as
+//! consecutive x, y, width and height values.
+void nvgRects(NVGcontext* ctx, const float* rects, int count);
+
+//! Creates one circle shaped sub-path for each of count circles, given as consecutive
+//! center x, center y and radius values.
+void nvgCircles(NVGcontext* ctx, const float* circles, int count);
+
+//! Creates one sub-path with a single line for each of count line segments, given as
+//! consecutive start x, start y, end x and end y values.
+void nvgLineSegments(NVGcontext* ctx, const float* points, int count);
+
 //! Fills the current path with current fill style.
 void nvgFill(NVGcontext* ctx);
 
 //! Fills the current path with current stroke style.
 void nvgStroke(NVGcontext* ctx);
 
+//
+//! Geometry
+//
+//! The current path can be tessellated once into geometry that is drawn many times.
+//! The geometry is tessellated in the current transform, and its vertices are transformed
+//! again when drawn. As the anti-aliasing fringe and stroke width are baked into the
+//! vertices, the draw transform should only translate, rotate and scale uniformly by a
+//! factor close to one.
+
+typedef struct NVGgeometry NVGgeometry;
+struct NVGvertex;
+
+//! Tessellates the current path for filling.
+NVGgeometry* nvgCreateFillGeometry(NVGcontext* ctx);
+
+//! Tessellates the current path for stroking with current stroke style.
+NVGgeometry* nvgCreateStrokeGeometry(NVGcontext* ctx);
+
+//! Draws geometry with the current fill or stroke style, after transforming its
+//! vertices by the given transform.
+void nvgDrawGeometry(NVGcontext* ctx, NVGgeometry* geometry, const float* xform);
+
+//! Draws geometry once for every transform, with the current fill or stroke style multiplied
+//! by a color per instance. Transforms are six floats each, like the one of nvgDrawGeometry.
+//! If ncolors is 0 the instances are not tinted, if it is 1 all instances share the color.
+//! Otherwise there must be a color for every instance, or nothing is drawn.
+//! Convex fills are drawn in a single instanced call when the back-end supports it.
+void nvgDrawInstances(NVGcontext* ctx, NVGgeometry* geometry, const float* xforms, const NVGcolor* colors, int ncolors, int count);
+
+//! Draws a list of textured triangles, three vertices each, with the current transform,
+//! composite operation and scissor. The u and v coordinates of the vertices are
+//! texture coordinates in the image, and the image is multiplied by a given color.
+//! Triangles are drawn whichever way they are wound.
+void nvgDrawTriangles(NVGcontext* ctx, int image, NVGcolor color, const struct NVGvertex* verts, int nverts);
+
+//! Returns the number of vertices of the geometry.
+int nvgGeometryVertexCount(const NVGgeometry* geometry);
+
+//! Deletes geometry.
+void nvgDeleteGeometry(NVGgeometry* geometry);
+
+//! Returns the current stroke width, miter limit, line cap and line join.
+void nvgCurrentStrokeStyle(NVGcontext* ctx, float* width, float* miterLimit, int* lineCap, int* lineJoin);
+
+//! Returns 1 if shapes are currently drawn anti-aliased.
+int nvgCurrentAntiAlias(NVGcontext* ctx);
+
+//! Returns the device pixel ratio of the current frame.
+float nvgDevicePixelRatio(NVGcontext* ctx);
+
 
 //
 //! Text
@@ -657,15 +736,19 @@ struct NVGparams {
 	int edgeAntiAlias;
 	int (*renderCreate)(void* uptr);
 	int (*renderCreateTexture)(void* uptr, int type, int w, int h, int imageFlags, const unsigned char* data);
+	int (*renderCreateTextureLevels)(void* uptr, int type, int w, int h, int imageFlags, const unsigned char* const* levels, int nlevels);
 	int (*renderDeleteTexture)(void* uptr, int image);
 	int (*renderUpdateTexture)(void* uptr, int image, int x, int y, int w, int h, const unsigned char* data);
+	int (*renderUpdateTextureRegion)(void* uptr, int image, int x, int y, int w, int h, int stride, const unsigned char* data);
 	int (*renderGetTextureSize)(void* uptr, int image, int* w, int* h);
+	int (*renderGetTextureFormat)(void* uptr, int image, int* type, int* imageFlags);
 	void (*renderViewport)(void* uptr, float width, float height, float devicePixelRatio);
 	void (*renderCancel)(void* uptr);
 	void (*renderFlush)(void* uptr);
 	void (*renderFill)(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, float fringe, const float* bounds, const NVGpath* paths, int npaths);
 	void (*renderStroke)(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, float fringe, float strokeWidth, const NVGpath* paths, int npaths);
 	void (*renderTriangles)(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, const NVGvertex* verts, int nverts);
+	int (*renderInstances)(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, float fringe, const NVGpath* paths, int npaths, const float* xforms, const NVGcolor* colors, int ncolors, int ninstances);
 	void (*renderDelete)(void* uptr);
 };
 typedef struct NVGparams NVGparams;
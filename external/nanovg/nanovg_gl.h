@@ -34,6 +34,36 @@ enum NVGcreateFlags {
 	NVG_DEBUG 			= 1<<2,
 };
 
+// Counters of the work done by the back-end since the context was created or the counters
+// were reset.
+struct NVGLstats {
+	// Number of flushes that drew anything.
+	int flushes;
+	// Number of times writing to a streaming buffer restarted at its start.
+	int streamWraps;
+	// Number of times data was about to overwrite a part of a streaming buffer the GPU was
+	// still reading, and the CPU had to wait for it.
+	int streamStalls;
+	// Number of times a streaming buffer was given new storage, either because it had to grow
+	// or because it wrapped without fences to wait on.
+	int streamOrphans;
+	// Number of calls submitted by the front-end.
+	int calls;
+	// Number of submitted calls drawn together with the calls before them, because they share
+	// their state.
+	int mergedCalls;
+	// Number of draw commands issued to OpenGL.
+	int drawCalls;
+	// Number of calls whose instances were drawn with instancing on the GPU.
+	int instancedCalls;
+	// Number of changes of call type, image or blending between consecutive calls, in the order
+	// the calls were submitted in.
+	int submittedStateChanges;
+	// Number of such changes in the order the calls were drawn in, after reordering.
+	int stateChanges;
+};
+typedef struct NVGLstats NVGLstats;
+
 #if defined NANOVG_GL2_IMPLEMENTATION
 #  define NANOVG_GL2 1
 #  define NANOVG_GL_IMPLEMENTATION 1
@@ -51,6 +81,37 @@ enum NVGcreateFlags {
 
 #define NANOVG_GL_USE_STATE_FILTER (1)
 
+// Instanced drawing needs vertex attribute divisors, which are core in OpenGL 3.3
+// and OpenGL ES 3.0. It is enabled at runtime when the context supports it.
+#if defined NANOVG_GL3 || defined NANOVG_GLES3
+#  define NANOVG_GL_USE_INSTANCING 1
+#endif
+
+// Large texture region updates are streamed through a pixel buffer object, so the transfer to
+// the texture does not stall the caller. Pixel buffers are core in OpenGL 2.1 and OpenGL ES 3.0.
+#if defined NANOVG_GL3 || defined NANOVG_GLES3
+#  define NANOVG_GL_USE_PIXEL_BUFFER 1
+#  define NANOVG_GL_PIXEL_BUFFER_MIN_SIZE (64*1024)
+#endif
+
+// Vertices, uniforms and instances are streamed through ring buffers which are mapped without
+// synchronization, rather than reallocated on every flush. Fences keep the writes from
+// overwriting data the GPU still reads, and without fences the buffers are orphaned on wrap.
+#if (defined NANOVG_GL3 || defined NANOVG_GLES3) && !defined NANOVG_GL_NO_STREAM_RING
+#  define NANOVG_GL_USE_STREAM_RING 1
+#  define NANOVG_GL_STREAM_BUFFER_SIZE (4*1024*1024)
+#  define NANOVG_GL_STREAM_FENCES 16
+#endif
+
+// Calls are moved back at most this many places when they are reordered.
+#define NANOVG_GL_REORDER_WINDOW 64
+
+// The fans and strips of several paths are drawn with one command. OpenGL ES has no
+// glMultiDrawArrays, so there they are drawn one by one.
+#if defined NANOVG_GL2 || defined NANOVG_GL3
+#  define NANOVG_GL_USE_MULTI_DRAW 1
+#endif
+
 // Creates NanoVG contexts for different OpenGL (ES) versions.
 // Flags should be combination of the create flags above.
 
@@ -62,6 +123,11 @@ void nvgDeleteGL2(NVGcontext* ctx);
 int nvglCreateImageFromHandleGL2(NVGcontext* ctx, GLuint textureId, int w, int h, int flags);
 GLuint nvglImageHandleGL2(NVGcontext* ctx, int image);
 
+// Restricts rendering to a rectangle of the framebuffer using the hardware scissor
+// test. Unlike nvgScissor() it is not transformed and survives nvgReset().
+// A negative width or height removes the restriction.
+void nvglSetClipRectGL2(NVGcontext* ctx, int x, int y, int w, int h);
+
 #endif
 
 #if defined NANOVG_GL3
@@ -72,6 +138,22 @@ void nvgDeleteGL3(NVGcontext* ctx);
 int nvglCreateImageFromHandleGL3(NVGcontext* ctx, GLuint textureId, int w, int h, int flags);
 GLuint nvglImageHandleGL3(NVGcontext* ctx, int image);
 
+// Restricts rendering to a rectangle of the framebuffer using the hardware scissor
+// test. Unlike nvgScissor() it is not transformed and survives nvgReset().
+// A negative width or height removes the restriction.
+void nvglSetClipRectGL3(NVGcontext* ctx, int x, int y, int w, int h);
+
+// Sets the capacity in bytes of each buffer that vertices, uniforms and instances are streamed
+// through. Buffers grow beyond it when a single flush does not fit.
+void nvglSetStreamBufferSizeGL3(NVGcontext* ctx, int size);
+
+// Copies the counters of the back-end to stats, and optionally resets them.
+void nvglGetStatsGL3(NVGcontext* ctx, NVGLstats* stats, int reset);
+
+// Sets whether calls which do not overlap may be drawn out of order at a flush, grouped by call
+// type, image and blending to reduce state changes. It is disabled by default.
+void nvglSetReorderCallsGL3(NVGcontext* ctx, int enable);
+
 #endif
 
 #if defined NANOVG_GLES2
@@ -82,6 +164,11 @@ void nvgDeleteGLES2(NVGcontext* ctx);
 int nvglCreateImageFromHandleGLES2(NVGcontext* ctx, GLuint textureId, int w, int h, int flags);
 GLuint nvglImageHandleGLES2(NVGcontext* ctx, int image);
 
+// Restricts rendering to a rectangle of the framebuffer using the hardware scissor
+// test. Unlike nvgScissor() it is not transformed and survives nvgReset().
+// A negative width or height removes the restriction.
+void nvglSetClipRectGLES2(NVGcontext* ctx, int x, int y, int w, int h);
+
 #endif
 
 #if defined NANOVG_GLES3
@@ -92,6 +179,22 @@ void nvgDeleteGLES3(NVGcontext* ctx);
 int nvglCreateImageFromHandleGLES3(NVGcontext* ctx, GLuint textureId, int w, int h, int flags);
 GLuint nvglImageHandleGLES3(NVGcontext* ctx, int image);
 
+// Restricts rendering to a rectangle of the framebuffer using the hardware scissor
+// test. Unlike nvgScissor() it is not transformed and survives nvgReset().
+// A negative width or height removes the restriction.
+void nvglSetClipRectGLES3(NVGcontext* ctx, int x, int y, int w, int h);
+
+// Sets the capacity in bytes of each buffer that vertices, uniforms and instances are streamed
+// through. Buffers grow beyond it when a single flush does not fit.
+void nvglSetStreamBufferSizeGLES3(NVGcontext* ctx, int size);
+
+// Copies the counters of the back-end to stats, and optionally resets them.
+void nvglGetStatsGLES3(NVGcontext* ctx, NVGLstats* stats, int reset);
+
+// Sets whether calls which do not overlap may be drawn out of order at a flush, grouped by call
+// type, image and blending to reduce state changes. It is disabled by default.
+void nvglSetReorderCallsGLES3(NVGcontext* ctx, int enable);
+
 #endif
 
 // These are additional flags on top of NVGimageFlags.
@@ -165,6 +268,7 @@ enum GLNVGcallType {
 	GLNVG_CONVEXFILL,
 	GLNVG_STROKE,
 	GLNVG_TRIANGLES,
+	GLNVG_INSTANCES,
 };
 
 struct GLNVGcall {
@@ -175,10 +279,21 @@ struct GLNVGcall {
 	int triangleOffset;
 	int triangleCount;
 	int uniformOffset;
+	int instanceOffset;
+	int instanceCount;
 	GLNVGblend blendFunc;
+	float bounds[4];
 };
 typedef struct GLNVGcall GLNVGcall;
 
+// Per instance attributes: the two rows of the transform and a premultiplied color
+struct GLNVGinstance {
+	float xformX[3];
+	float xformY[3];
+	float color[4];
+};
+typedef struct GLNVGinstance GLNVGinstance;
+
 struct GLNVGpath {
 	int fillOffset;
 	int fillCount;
@@ -228,6 +343,23 @@ struct GLNVGfragUniforms {
 };
 typedef struct GLNVGfragUniforms GLNVGfragUniforms;
 
+#if NANOVG_GL_USE_STREAM_RING
+// A buffer written front to back, one part per flush. Each part is fenced after it is drawn,
+// and the fences are kept oldest first.
+struct GLNVGring {
+	GLenum target;
+	GLsizeiptr size;
+	GLintptr head;
+	GLsync fences[NANOVG_GL_STREAM_FENCES];
+	GLintptr fenceStart[NANOVG_GL_STREAM_FENCES];
+	GLintptr fenceEnd[NANOVG_GL_STREAM_FENCES];
+	int nfences;
+	GLintptr partStart;
+	GLintptr partEnd;
+};
+typedef struct GLNVGring GLNVGring;
+#endif
+
 struct GLNVGcontext {
 	GLNVGshader shader;
 	GLNVGtexture* textures;
@@ -244,6 +376,36 @@ struct GLNVGcontext {
 #endif
 	int fragSize;
 	int flags;
+	int clipRect[4];
+#if NANOVG_GL_USE_INSTANCING
+	int instancing;
+	int instancingARB;
+	GLuint instBuf;
+#endif
+#if NANOVG_GL_USE_PIXEL_BUFFER
+	GLuint unpackBuf;
+#endif
+#if NANOVG_GL_USE_STREAM_RING
+	int fences;
+	int streamSize;
+	GLNVGring vertRing;
+	GLNVGring fragRing;
+	GLNVGring instRing;
+#endif
+	GLintptr fragBase;
+	GLintptr instBase;
+	NVGLstats stats;
+#if NANOVG_GL_USE_MULTI_DRAW
+	GLint* drawFirsts;
+	GLsizei* drawCounts;
+	int cdraws;
+#endif
+	int reorder;
+	int* order;
+	GLNVGcall* sortCalls;
+	int corder;
+	GLNVGpath* sortPaths;
+	int csortPaths;
 
 	// Per frame buffers
 	GLNVGcall* calls;
@@ -258,6 +420,9 @@ struct GLNVGcontext {
 	unsigned char* uniforms;
 	int cuniforms;
 	int nuniforms;
+	GLNVGinstance* instances;
+	int cinstances;
+	int ninstances;
 
 	// cached state
 	#if NANOVG_GL_USE_STATE_FILTER
@@ -272,6 +437,8 @@ struct GLNVGcontext {
 typedef struct GLNVGcontext GLNVGcontext;
 
 static int glnvg__maxi(int a, int b) { return a > b ? a : b; }
+static float glnvg__minf(float a, float b) { return a < b ? a : b; }
+static float glnvg__maxf(float a, float b) { return a > b ? a : b; }
 
 #ifdef NANOVG_GLES2
 static unsigned int glnvg__nearestPow2(unsigned int num)
@@ -463,6 +630,9 @@ static int glnvg__createShader(GLNVGshader* shader, const char* name, const char
 
 	glBindAttribLocation(prog, 0, "vertex");
 	glBindAttribLocation(prog, 1, "tcoord");
+	glBindAttribLocation(prog, 2, "xformX");
+	glBindAttribLocation(prog, 3, "xformY");
+	glBindAttribLocation(prog, 4, "color");
 
 	glLinkProgram(prog);
 	glGetProgramiv(prog, GL_LINK_STATUS, &status);
@@ -500,6 +670,20 @@ static void glnvg__getUniforms(GLNVGshader* shader)
 #endif
 }
 
+#if NANOVG_GL_USE_INSTANCING && defined NANOVG_GL3
+static int glnvg__hasExtension(const char* name)
+{
+	GLint i, count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+	for (i = 0; i < count; i++) {
+		const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+		if (extension != NULL && strcmp(extension, name) == 0)
+			return 1;
+	}
+	return 0;
+}
+#endif
+
 static int glnvg__renderCreate(void* uptr)
 {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
@@ -533,8 +717,12 @@ static int glnvg__renderCreate(void* uptr)
 		"	uniform vec2 viewSize;\n"
 		"	in vec2 vertex;\n"
 		"	in vec2 tcoord;\n"
+		"	in vec3 xformX;\n"
+		"	in vec3 xformY;\n"
+		"	in vec4 color;\n"
 		"	out vec2 ftcoord;\n"
 		"	out vec2 fpos;\n"
+		"	out vec4 fcolor;\n"
 		"#else\n"
 		"	uniform vec2 viewSize;\n"
 		"	attribute vec2 vertex;\n"
@@ -543,9 +731,16 @@ static int glnvg__renderCreate(void* uptr)
 		"	varying vec2 fpos;\n"
 		"#endif\n"
 		"void main(void) {\n"
+		"#ifdef NANOVG_GL3\n"
+		"	// Identity and white unless drawing instances\n"
+		"	vec2 pos = vec2(dot(xformX, vec3(vertex,1.0)), dot(xformY, vec3(vertex,1.0)));\n"
+		"	fcolor = color;\n"
+		"#else\n"
+		"	vec2 pos = vertex;\n"
+		"#endif\n"
 		"	ftcoord = tcoord;\n"
-		"	fpos = vertex;\n"
-		"	gl_Position = vec4(2.0*vertex.x/viewSize.x - 1.0, 1.0 - 2.0*vertex.y/viewSize.y, 0, 1);\n"
+		"	fpos = pos;\n"
+		"	gl_Position = vec4(2.0*pos.x/viewSize.x - 1.0, 1.0 - 2.0*pos.y/viewSize.y, 0, 1);\n"
 		"}\n";
 
 	static const char* fillFragShader =
@@ -579,6 +774,7 @@ static int glnvg__renderCreate(void* uptr)
 		"	uniform sampler2D tex;\n"
 		"	in vec2 ftcoord;\n"
 		"	in vec2 fpos;\n"
+		"	in vec4 fcolor;\n"
 		"	out vec4 outColor;\n"
 		"#else\n" // !NANOVG_GL3
 		"	uniform vec4 frag[UNIFORMARRAY_SIZE];\n"
@@ -667,7 +863,7 @@ static int glnvg__renderCreate(void* uptr)
 		"		result = color * innerCol;\n"
 		"	}\n"
 		"#ifdef NANOVG_GL3\n"
-		"	outColor = result;\n"
+		"	outColor = result * fcolor;\n"
 		"#else\n"
 		"	gl_FragColor = result;\n"
 		"#endif\n"
@@ -692,6 +888,24 @@ static int glnvg__renderCreate(void* uptr)
 #endif
 	glGenBuffers(1, &gl->vertBuf);
 
+#if NANOVG_GL_USE_INSTANCING
+	{
+		GLint major = 0, minor = 0;
+		glGetIntegerv(GL_MAJOR_VERSION, &major);
+		glGetIntegerv(GL_MINOR_VERSION, &minor);
+#if defined NANOVG_GLES3
+		gl->instancing = major >= 3;
+#else
+		gl->instancing = major > 3 || (major == 3 && minor >= 3);
+		// Earlier contexts may still have the divisors as an extension.
+		if (!gl->instancing && glnvg__hasExtension("GL_ARB_instanced_arrays"))
+			gl->instancing = gl->instancingARB = 1;
+#endif
+		if (gl->instancing)
+			glGenBuffers(1, &gl->instBuf);
+	}
+#endif
+
 #if NANOVG_GL_USE_UNIFORMBUFFER
 	// Create UBOs
 	glUniformBlockBinding(gl->shader.prog, gl->shader.loc[GLNVG_LOC_FRAG], GLNVG_FRAG_BINDING);
@@ -700,6 +914,26 @@ static int glnvg__renderCreate(void* uptr)
 #endif
 	gl->fragSize = sizeof(GLNVGfragUniforms) + align - sizeof(GLNVGfragUniforms) % align;
 
+#if NANOVG_GL_USE_STREAM_RING
+	{
+		// Fences are core in OpenGL 3.2 and OpenGL ES 3.0.
+		GLint major = 0, minor = 0;
+		glGetIntegerv(GL_MAJOR_VERSION, &major);
+		glGetIntegerv(GL_MINOR_VERSION, &minor);
+#if defined NANOVG_GLES3
+		gl->fences = major >= 3;
+#else
+		gl->fences = major > 3 || (major == 3 && minor >= 2);
+#endif
+	}
+	gl->streamSize = NANOVG_GL_STREAM_BUFFER_SIZE;
+	gl->vertRing.target = GL_ARRAY_BUFFER;
+	gl->instRing.target = GL_ARRAY_BUFFER;
+#if NANOVG_GL_USE_UNIFORMBUFFER
+	gl->fragRing.target = GL_UNIFORM_BUFFER;
+#endif
+#endif
+
 	glnvg__checkError(gl, "create done");
 
 	glFinish();
@@ -707,6 +941,20 @@ static int glnvg__renderCreate(void* uptr)
 	return 1;
 }
 
+static void glnvg__texImage(int type, int level, int w, int h, const unsigned char* data)
+{
+	if (type == NVG_TEXTURE_RGBA)
+		glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	else
+#if defined(NANOVG_GLES2) || defined (NANOVG_GL2)
+		glTexImage2D(GL_TEXTURE_2D, level, GL_LUMINANCE, w, h, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, data);
+#elif defined(NANOVG_GLES3)
+		glTexImage2D(GL_TEXTURE_2D, level, GL_R8, w, h, 0, GL_RED, GL_UNSIGNED_BYTE, data);
+#else
+		glTexImage2D(GL_TEXTURE_2D, level, GL_RED, w, h, 0, GL_RED, GL_UNSIGNED_BYTE, data);
+#endif
+}
+
 static int glnvg__renderCreateTexture(void* uptr, int type, int w, int h, int imageFlags, const unsigned char* data)
 {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
@@ -751,16 +999,7 @@ static int glnvg__renderCreateTexture(void* uptr, int type, int w, int h, int im
 	}
 #endif
 
-	if (type == NVG_TEXTURE_RGBA)
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-	else
-#if defined(NANOVG_GLES2) || defined (NANOVG_GL2)
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, w, h, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, data);
-#elif defined(NANOVG_GLES3)
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, w, h, 0, GL_RED, GL_UNSIGNED_BYTE, data);
-#else
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, w, h, 0, GL_RED, GL_UNSIGNED_BYTE, data);
-#endif
+	glnvg__texImage(type, 0, w, h, data);
 
 	if (imageFlags & NVG_IMAGE_GENERATE_MIPMAPS) {
 		if (imageFlags & NVG_IMAGE_NEAREST) {
@@ -813,6 +1052,52 @@ static int glnvg__renderCreateTexture(void* uptr, int type, int w, int h, int im
 }
 
 
+static int glnvg__renderCreateTextureLevels(void* uptr, int type, int w, int h, int imageFlags, const unsigned char* const* levels, int nlevels)
+{
+	GLNVGcontext* gl = (GLNVGcontext*)uptr;
+	GLNVGtexture* tex = NULL;
+	int image, i;
+
+	// Create level 0 as usual, and upload the rest of the chain instead of generating it.
+	if (nlevels < 2)
+		return glnvg__renderCreateTexture(uptr, type, w, h, imageFlags, levels[0]);
+	image = glnvg__renderCreateTexture(uptr, type, w, h, imageFlags & ~NVG_IMAGE_GENERATE_MIPMAPS, levels[0]);
+	if (image == 0) return image;
+
+#ifdef NANOVG_GLES2
+	// No mips for non-power of 2.
+	if (glnvg__nearestPow2(w) != (unsigned int)w || glnvg__nearestPow2(h) != (unsigned int)h)
+		return image;
+#endif
+
+	tex = glnvg__findTexture(gl, image);
+	tex->flags |= NVG_IMAGE_GENERATE_MIPMAPS;
+	glnvg__bindTexture(gl, tex->tex);
+	glPixelStorei(GL_UNPACK_ALIGNMENT,1);
+
+	for (i = 1; i < nlevels; i++) {
+		w = w > 1 ? w / 2 : 1;
+		h = h > 1 ? h / 2 : 1;
+		glnvg__texImage(type, i, w, h, levels[i]);
+	}
+
+#ifndef NANOVG_GLES2
+	// GLES2 has no max level, so the chain has to go all the way down to 1x1 there.
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, nlevels - 1);
+#endif
+	if (imageFlags & NVG_IMAGE_NEAREST) {
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	} else {
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	glnvg__checkError(gl, "create tex levels");
+	glnvg__bindTexture(gl, 0);
+
+	return image;
+}
+
 static int glnvg__renderDeleteTexture(void* uptr, int image)
 {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
@@ -864,6 +1149,63 @@ static int glnvg__renderUpdateTexture(void* uptr, int image, int x, int y, int w
 	return 1;
 }
 
+static int glnvg__renderUpdateTextureRegion(void* uptr, int image, int x, int y, int w, int h, int stride, const unsigned char* data)
+{
+	GLNVGcontext* gl = (GLNVGcontext*)uptr;
+	GLNVGtexture* tex = glnvg__findTexture(gl, image);
+	GLenum format;
+#if NANOVG_GL_USE_PIXEL_BUFFER
+	GLsizeiptr size;
+#endif
+
+	if (tex == NULL) return 0;
+	glnvg__bindTexture(gl, tex->tex);
+
+	if (tex->type == NVG_TEXTURE_RGBA)
+		format = GL_RGBA;
+	else
+#if defined(NANOVG_GLES2) || defined(NANOVG_GL2)
+		format = GL_LUMINANCE;
+#else
+		format = GL_RED;
+#endif
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT,1);
+
+#ifndef NANOVG_GLES2
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, stride);
+#if NANOVG_GL_USE_PIXEL_BUFFER
+	size = ((h-1) * stride + w) * (tex->type == NVG_TEXTURE_RGBA ? 4 : 1);
+	if (size >= NANOVG_GL_PIXEL_BUFFER_MIN_SIZE) {
+		if (gl->unpackBuf == 0)
+			glGenBuffers(1, &gl->unpackBuf);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, gl->unpackBuf);
+		// Replaces the storage rather than writing into it, so earlier transfers are not waited for.
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, size, data, GL_STREAM_DRAW);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, x,y, w,h, format, GL_UNSIGNED_BYTE, NULL);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	} else
+#endif
+		glTexSubImage2D(GL_TEXTURE_2D, 0, x,y, w,h, format, GL_UNSIGNED_BYTE, data);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+#else
+	// No support for row length, so update one row at a time unless the rows are packed.
+	if (stride == w) {
+		glTexSubImage2D(GL_TEXTURE_2D, 0, x,y, w,h, format, GL_UNSIGNED_BYTE, data);
+	} else {
+		int i, bpp = tex->type == NVG_TEXTURE_RGBA ? 4 : 1;
+		for (i = 0; i < h; i++)
+			glTexSubImage2D(GL_TEXTURE_2D, 0, x,y+i, w,1, format, GL_UNSIGNED_BYTE, data + i*stride*bpp);
+	}
+#endif
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	glnvg__bindTexture(gl, 0);
+
+	return 1;
+}
+
 static int glnvg__renderGetTextureSize(void* uptr, int image, int* w, int* h)
 {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
@@ -874,6 +1216,16 @@ static int glnvg__renderGetTextureSize(void* uptr, int image, int* w, int* h)
 	return 1;
 }
 
+static int glnvg__renderGetTextureFormat(void* uptr, int image, int* type, int* imageFlags)
+{
+	GLNVGcontext* gl = (GLNVGcontext*)uptr;
+	GLNVGtexture* tex = glnvg__findTexture(gl, image);
+	if (tex == NULL) return 0;
+	*type = tex->type;
+	*imageFlags = tex->flags;
+	return 1;
+}
+
 static void glnvg__xformToMat3x4(float* m3, float* t)
 {
 	m3[0] = t[0];
@@ -961,7 +1313,12 @@ static int glnvg__convertPaint(GLNVGcontext* gl, GLNVGfragUniforms* frag, NVGpai
 		frag->type = NSVG_SHADER_FILLGRAD;
 		frag->radius = paint->radius;
 		frag->feather = paint->feather;
-		nvgTransformInverse(invxform, paint->xform);
+		// A solid color does not depend on the paint transform. Leaving it out lets calls with the
+		// same color but different transforms share their uniforms, and be merged.
+		if (memcmp(&paint->innerColor, &paint->outerColor, sizeof(NVGcolor)) == 0)
+			nvgTransformIdentity(invxform);
+		else
+			nvgTransformInverse(invxform, paint->xform);
 	}
 
 	glnvg__xformToMat3x4(frag->paintMat, invxform);
@@ -974,7 +1331,7 @@ static GLNVGfragUniforms* nvg__fragUniformPtr(GLNVGcontext* gl, int i);
 static void glnvg__setUniforms(GLNVGcontext* gl, int uniformOffset, int image)
 {
 #if NANOVG_GL_USE_UNIFORMBUFFER
-	glBindBufferRange(GL_UNIFORM_BUFFER, GLNVG_FRAG_BINDING, gl->fragBuf, uniformOffset, sizeof(GLNVGfragUniforms));
+	glBindBufferRange(GL_UNIFORM_BUFFER, GLNVG_FRAG_BINDING, gl->fragBuf, gl->fragBase + uniformOffset, sizeof(GLNVGfragUniforms));
 #else
 	GLNVGfragUniforms* frag = nvg__fragUniformPtr(gl, uniformOffset);
 	glUniform4fv(gl->shader.loc[GLNVG_LOC_FRAG], NANOVG_GL_UNIFORMARRAY_SIZE, &(frag->uniformArray[0][0]));
@@ -997,10 +1354,60 @@ static void glnvg__renderViewport(void* uptr, float width, float height, float d
 	gl->view[1] = height;
 }
 
+#if NANOVG_GL_USE_MULTI_DRAW
+static int glnvg__allocDraws(GLNVGcontext* gl, int n)
+{
+	GLint* firsts;
+	GLsizei* counts;
+	int cdraws;
+	if (n > gl->cdraws) {
+		cdraws = glnvg__maxi(n, 128) + gl->cdraws/2; // 1.5x Overallocate
+		firsts = (GLint*)realloc(gl->drawFirsts, sizeof(GLint) * cdraws);
+		if (firsts == NULL) return -1;
+		gl->drawFirsts = firsts;
+		counts = (GLsizei*)realloc(gl->drawCounts, sizeof(GLsizei) * cdraws);
+		if (counts == NULL) return -1;
+		gl->drawCounts = counts;
+		gl->cdraws = cdraws;
+	}
+	return 0;
+}
+#endif
+
+// Draws the fills or the strokes of paths, with a single command where multi-draw is available.
+static void glnvg__drawPaths(GLNVGcontext* gl, GLenum mode, const GLNVGpath* paths, int npaths, int fill)
+{
+	int i, first, count;
+#if NANOVG_GL_USE_MULTI_DRAW
+	int n = 0;
+	if (npaths > 1 && glnvg__allocDraws(gl, npaths) == 0) {
+		for (i = 0; i < npaths; i++) {
+			count = fill ? paths[i].fillCount : paths[i].strokeCount;
+			if (count == 0) continue;
+			gl->drawFirsts[n] = fill ? paths[i].fillOffset : paths[i].strokeOffset;
+			gl->drawCounts[n] = count;
+			n++;
+		}
+		if (n > 0) {
+			glMultiDrawArrays(mode, gl->drawFirsts, gl->drawCounts, n);
+			gl->stats.drawCalls++;
+		}
+		return;
+	}
+#endif
+	for (i = 0; i < npaths; i++) {
+		first = fill ? paths[i].fillOffset : paths[i].strokeOffset;
+		count = fill ? paths[i].fillCount : paths[i].strokeCount;
+		if (count == 0) continue;
+		glDrawArrays(mode, first, count);
+		gl->stats.drawCalls++;
+	}
+}
+
 static void glnvg__fill(GLNVGcontext* gl, GLNVGcall* call)
 {
 	GLNVGpath* paths = &gl->paths[call->pathOffset];
-	int i, npaths = call->pathCount;
+	int npaths = call->pathCount;
 
 	// Draw shapes
 	glEnable(GL_STENCIL_TEST);
@@ -1015,8 +1422,7 @@ static void glnvg__fill(GLNVGcontext* gl, GLNVGcall* call)
 	glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_KEEP, GL_INCR_WRAP);
 	glStencilOpSeparate(GL_BACK, GL_KEEP, GL_KEEP, GL_DECR_WRAP);
 	glDisable(GL_CULL_FACE);
-	for (i = 0; i < npaths; i++)
-		glDrawArrays(GL_TRIANGLE_FAN, paths[i].fillOffset, paths[i].fillCount);
+	glnvg__drawPaths(gl, GL_TRIANGLE_FAN, paths, npaths, 1);
 	glEnable(GL_CULL_FACE);
 
 	// Draw anti-aliased pixels
@@ -1029,14 +1435,14 @@ static void glnvg__fill(GLNVGcontext* gl, GLNVGcall* call)
 		glnvg__stencilFunc(gl, GL_EQUAL, 0x00, 0xff);
 		glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 		// Draw fringes
-		for (i = 0; i < npaths; i++)
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+		glnvg__drawPaths(gl, GL_TRIANGLE_STRIP, paths, npaths, 0);
 	}
 
 	// Draw fill
 	glnvg__stencilFunc(gl, GL_NOTEQUAL, 0x0, 0xff);
 	glStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
 	glDrawArrays(GL_TRIANGLE_STRIP, call->triangleOffset, call->triangleCount);
+	gl->stats.drawCalls++;
 
 	glDisable(GL_STENCIL_TEST);
 }
@@ -1044,24 +1450,22 @@ static void glnvg__fill(GLNVGcontext* gl, GLNVGcall* call)
 static void glnvg__convexFill(GLNVGcontext* gl, GLNVGcall* call)
 {
 	GLNVGpath* paths = &gl->paths[call->pathOffset];
-	int i, npaths = call->pathCount;
+	int npaths = call->pathCount;
 
 	glnvg__setUniforms(gl, call->uniformOffset, call->image);
 	glnvg__checkError(gl, "convex fill");
 
-	for (i = 0; i < npaths; i++)
-		glDrawArrays(GL_TRIANGLE_FAN, paths[i].fillOffset, paths[i].fillCount);
+	glnvg__drawPaths(gl, GL_TRIANGLE_FAN, paths, npaths, 1);
 	if (gl->flags & NVG_ANTIALIAS) {
 		// Draw fringes
-		for (i = 0; i < npaths; i++)
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+		glnvg__drawPaths(gl, GL_TRIANGLE_STRIP, paths, npaths, 0);
 	}
 }
 
 static void glnvg__stroke(GLNVGcontext* gl, GLNVGcall* call)
 {
 	GLNVGpath* paths = &gl->paths[call->pathOffset];
-	int npaths = call->pathCount, i;
+	int npaths = call->pathCount;
 
 	if (gl->flags & NVG_STENCIL_STROKES) {
 
@@ -1073,23 +1477,20 @@ static void glnvg__stroke(GLNVGcontext* gl, GLNVGcall* call)
 		glStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
 		glnvg__setUniforms(gl, call->uniformOffset + gl->fragSize, call->image);
 		glnvg__checkError(gl, "stroke fill 0");
-		for (i = 0; i < npaths; i++)
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+		glnvg__drawPaths(gl, GL_TRIANGLE_STRIP, paths, npaths, 0);
 
 		// Draw anti-aliased pixels.
 		glnvg__setUniforms(gl, call->uniformOffset, call->image);
 		glnvg__stencilFunc(gl, GL_EQUAL, 0x00, 0xff);
 		glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
-		for (i = 0; i < npaths; i++)
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+		glnvg__drawPaths(gl, GL_TRIANGLE_STRIP, paths, npaths, 0);
 
 		// Clear stencil buffer.
 		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
 		glnvg__stencilFunc(gl, GL_ALWAYS, 0x0, 0xff);
 		glStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
 		glnvg__checkError(gl, "stroke fill 1");
-		for (i = 0; i < npaths; i++)
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+		glnvg__drawPaths(gl, GL_TRIANGLE_STRIP, paths, npaths, 0);
 		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 
 		glDisable(GL_STENCIL_TEST);
@@ -1100,8 +1501,7 @@ static void glnvg__stroke(GLNVGcontext* gl, GLNVGcall* call)
 		glnvg__setUniforms(gl, call->uniformOffset, call->image);
 		glnvg__checkError(gl, "stroke fill");
 		// Draw Strokes
-		for (i = 0; i < npaths; i++)
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+		glnvg__drawPaths(gl, GL_TRIANGLE_STRIP, paths, npaths, 0);
 	}
 }
 
@@ -1111,7 +1511,69 @@ static void glnvg__triangles(GLNVGcontext* gl, GLNVGcall* call)
 	glnvg__checkError(gl, "triangles fill");
 
 	glDrawArrays(GL_TRIANGLES, call->triangleOffset, call->triangleCount);
+	gl->stats.drawCalls++;
+}
+
+#if NANOVG_GL_USE_INSTANCING
+static void glnvg__vertexAttribDivisor(GLNVGcontext* gl, GLuint index, GLuint divisor)
+{
+#if defined NANOVG_GL3
+	if (gl->instancingARB) {
+		glVertexAttribDivisorARB(index, divisor);
+		return;
+	}
+#else
+	NVG_NOTUSED(gl);
+#endif
+	glVertexAttribDivisor(index, divisor);
+}
+
+static void glnvg__resetInstanceAttribs(void)
+{
+	// Attributes without an array take these values, so regular calls are neither
+	// transformed nor tinted
+	glVertexAttrib3f(2, 1.0f, 0.0f, 0.0f);
+	glVertexAttrib3f(3, 0.0f, 1.0f, 0.0f);
+	glVertexAttrib4f(4, 1.0f, 1.0f, 1.0f, 1.0f);
+}
+
+static void glnvg__instances(GLNVGcontext* gl, GLNVGcall* call)
+{
+	GLNVGpath* paths = &gl->paths[call->pathOffset];
+	size_t offset = gl->instBase + call->instanceOffset * sizeof(GLNVGinstance);
+	int i;
+
+	glnvg__setUniforms(gl, call->uniformOffset, call->image);
+	glnvg__checkError(gl, "instances");
+	gl->stats.instancedCalls++;
+
+	glBindBuffer(GL_ARRAY_BUFFER, gl->instBuf);
+	for (i = 2; i <= 4; i++) {
+		glEnableVertexAttribArray(i);
+		glnvg__vertexAttribDivisor(gl, i, 1);
+	}
+	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(GLNVGinstance), (const GLvoid*)offset);
+	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(GLNVGinstance), (const GLvoid*)(offset + 3*sizeof(float)));
+	glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(GLNVGinstance), (const GLvoid*)(offset + 6*sizeof(float)));
+
+	for (i = 0; i < call->pathCount; i++)
+		glDrawArraysInstanced(GL_TRIANGLE_FAN, paths[i].fillOffset, paths[i].fillCount, call->instanceCount);
+	gl->stats.drawCalls += call->pathCount;
+	if (gl->flags & NVG_ANTIALIAS) {
+		// Draw fringes
+		for (i = 0; i < call->pathCount; i++)
+			glDrawArraysInstanced(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount, call->instanceCount);
+		gl->stats.drawCalls += call->pathCount;
+	}
+
+	for (i = 2; i <= 4; i++) {
+		glnvg__vertexAttribDivisor(gl, i, 0);
+		glDisableVertexAttribArray(i);
+	}
+	glnvg__resetInstanceAttribs();
+	glBindBuffer(GL_ARRAY_BUFFER, gl->vertBuf);
 }
+#endif
 
 static void glnvg__renderCancel(void* uptr) {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
@@ -1119,6 +1581,7 @@ static void glnvg__renderCancel(void* uptr) {
 	gl->npaths = 0;
 	gl->ncalls = 0;
 	gl->nuniforms = 0;
+	gl->ninstances = 0;
 }
 
 static GLenum glnvg_convertBlendFuncFactor(int factor)
@@ -1165,13 +1628,223 @@ static GLNVGblend glnvg__blendCompositeOperation(NVGcompositeOperationState op)
 	return blend;
 }
 
+#if NANOVG_GL_USE_STREAM_RING
+static void glnvg__ringDeleteFences(GLNVGring* ring)
+{
+	int i;
+	for (i = 0; i < ring->nfences; i++)
+		glDeleteSync(ring->fences[i]);
+	ring->nfences = 0;
+}
+
+static void glnvg__ringWaitOldest(GLNVGcontext* gl, GLNVGring* ring)
+{
+	GLenum status = glClientWaitSync(ring->fences[0], 0, 0);
+	if (status == GL_TIMEOUT_EXPIRED) {
+		gl->stats.streamStalls++;
+		do {
+			status = glClientWaitSync(ring->fences[0], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+		} while (status == GL_TIMEOUT_EXPIRED);
+	}
+	glDeleteSync(ring->fences[0]);
+	ring->nfences--;
+	memmove(&ring->fences[0], &ring->fences[1], ring->nfences * sizeof(GLsync));
+	memmove(&ring->fenceStart[0], &ring->fenceStart[1], ring->nfences * sizeof(GLintptr));
+	memmove(&ring->fenceEnd[0], &ring->fenceEnd[1], ring->nfences * sizeof(GLintptr));
+}
+
+// Writes data to the next free part of a ring buffer, which has to be bound, and returns the
+// offset it was written at.
+static GLintptr glnvg__ringWrite(GLNVGcontext* gl, GLNVGring* ring, const void* data, GLsizeiptr size, int align)
+{
+	GLintptr offset = (ring->head + align - 1) / align * align;
+	void* ptr;
+
+	if (size <= 0) return 0;
+
+	if (ring->size == 0 || size > ring->size) {
+		// New storage is never in use, so nothing has to be waited for.
+		if (ring->size != 0)
+			gl->stats.streamOrphans++;
+		ring->size = glnvg__maxi(gl->streamSize, (int)(size + size / 2));
+		glBufferData(ring->target, ring->size, NULL, GL_STREAM_DRAW);
+		glnvg__ringDeleteFences(ring);
+		offset = 0;
+	} else if (offset + size > ring->size) {
+		offset = 0;
+		gl->stats.streamWraps++;
+		if (!gl->fences) {
+			glBufferData(ring->target, ring->size, NULL, GL_STREAM_DRAW);
+			gl->stats.streamOrphans++;
+		}
+	}
+
+	// Parts are fenced in the order they were written, so the oldest ones are right ahead.
+	while (ring->nfences > 0 && ring->fenceStart[0] < offset + size && offset < ring->fenceEnd[0])
+		glnvg__ringWaitOldest(gl, ring);
+
+	ptr = glMapBufferRange(ring->target, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	if (ptr != NULL) {
+		memcpy(ptr, data, size);
+		glUnmapBuffer(ring->target);
+	} else {
+		glBufferSubData(ring->target, offset, size, data);
+	}
+
+	ring->head = offset + size;
+	ring->partStart = offset;
+	ring->partEnd = offset + size;
+	return offset;
+}
+
+// Fences the part written during this flush, once all calls reading it have been issued.
+static void glnvg__ringFence(GLNVGcontext* gl, GLNVGring* ring)
+{
+	if (gl->fences && ring->partEnd > ring->partStart) {
+		if (ring->nfences == NANOVG_GL_STREAM_FENCES)
+			glnvg__ringWaitOldest(gl, ring);
+		ring->fences[ring->nfences] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		ring->fenceStart[ring->nfences] = ring->partStart;
+		ring->fenceEnd[ring->nfences] = ring->partEnd;
+		ring->nfences++;
+	}
+	ring->partStart = ring->partEnd = 0;
+}
+#endif
+
+static int glnvg__allocReorder(GLNVGcontext* gl)
+{
+	int* order;
+	GLNVGcall* calls;
+	GLNVGpath* paths;
+	int corder, cpaths;
+	if (gl->ncalls > gl->corder) {
+		corder = glnvg__maxi(gl->ncalls, 128) + gl->corder/2; // 1.5x Overallocate
+		order = (int*)realloc(gl->order, sizeof(int) * corder);
+		if (order == NULL) return -1;
+		gl->order = order;
+		calls = (GLNVGcall*)realloc(gl->sortCalls, sizeof(GLNVGcall) * corder);
+		if (calls == NULL) return -1;
+		gl->sortCalls = calls;
+		gl->corder = corder;
+	}
+	if (gl->npaths > gl->csortPaths) {
+		cpaths = glnvg__maxi(gl->npaths, 128) + gl->csortPaths/2; // 1.5x Overallocate
+		paths = (GLNVGpath*)realloc(gl->sortPaths, sizeof(GLNVGpath) * cpaths);
+		if (paths == NULL) return -1;
+		gl->sortPaths = paths;
+		gl->csortPaths = cpaths;
+	}
+	return 0;
+}
+
+static int glnvg__sameState(const GLNVGcall* a, const GLNVGcall* b)
+{
+	return a->type == b->type && a->image == b->image &&
+		memcmp(&a->blendFunc, &b->blendFunc, sizeof(GLNVGblend)) == 0;
+}
+
+static int glnvg__overlaps(const GLNVGcall* a, const GLNVGcall* b)
+{
+	// Instances are placed by their transforms, so their bounds are not known.
+	if (a->type == GLNVG_INSTANCES || b->type == GLNVG_INSTANCES)
+		return 1;
+	return a->bounds[0] <= b->bounds[2] && b->bounds[0] <= a->bounds[2] &&
+		a->bounds[1] <= b->bounds[3] && b->bounds[1] <= a->bounds[3];
+}
+
+static int glnvg__countStateChanges(const GLNVGcall* calls, int ncalls)
+{
+	int i, count = 0;
+	for (i = 1; i < ncalls; i++) {
+		if (!glnvg__sameState(&calls[i-1], &calls[i]))
+			count++;
+	}
+	return count;
+}
+
+// Moves each call back to follow the last call with the same state, unless it overlaps a call it
+// would move past. Calls that overlap keep their order, so the result looks the same.
+static void glnvg__reorderCalls(GLNVGcontext* gl)
+{
+	int i, j, k, n = 0, npaths = 0;
+
+	if (glnvg__allocReorder(gl) == -1) return;
+
+	for (i = 0; i < gl->ncalls; i++) {
+		const GLNVGcall* call = &gl->calls[i];
+		k = n;
+		for (j = n-1; j >= 0 && j >= n - NANOVG_GL_REORDER_WINDOW; j--) {
+			const GLNVGcall* other = &gl->calls[gl->order[j]];
+			if (glnvg__sameState(other, call)) {
+				k = j+1;
+				break;
+			}
+			if (glnvg__overlaps(other, call))
+				break;
+		}
+		memmove(&gl->order[k+1], &gl->order[k], sizeof(int) * (n-k));
+		gl->order[k] = i;
+		n++;
+	}
+
+	// The paths are copied in the new order too, so calls merged afterwards have theirs in a row.
+	for (i = 0; i < n; i++) {
+		GLNVGcall* call = &gl->sortCalls[i];
+		*call = gl->calls[gl->order[i]];
+		memcpy(&gl->sortPaths[npaths], &gl->paths[call->pathOffset], sizeof(GLNVGpath) * call->pathCount);
+		call->pathOffset = npaths;
+		npaths += call->pathCount;
+	}
+	memcpy(gl->calls, gl->sortCalls, sizeof(GLNVGcall) * n);
+	memcpy(gl->paths, gl->sortPaths, sizeof(GLNVGpath) * npaths);
+}
+
+// Extends a run of calls with the next call when it draws with the same state, so the run is
+// drawn as one call. Only calls drawn without stencil passes qualify, their uniforms have to
+// match byte for byte, and their paths or vertices have to follow each other.
+static int glnvg__mergeCall(GLNVGcontext* gl, GLNVGcall* run, const GLNVGcall* call)
+{
+	const GLNVGblend* blend = &run->blendFunc;
+	if (call->type != run->type || call->image != run->image ||
+		memcmp(&call->blendFunc, blend, sizeof(GLNVGblend)) != 0 ||
+		memcmp(nvg__fragUniformPtr(gl, call->uniformOffset), nvg__fragUniformPtr(gl, run->uniformOffset), sizeof(GLNVGfragUniforms)) != 0)
+		return 0;
+
+	if (run->type == GLNVG_CONVEXFILL || (run->type == GLNVG_STROKE && (gl->flags & NVG_STENCIL_STROKES) == 0)) {
+		// The fills of a convex run are drawn before all of its fringes. With the same paint,
+		// source over blends to the same result in any order, other operations may not.
+		if (run->type == GLNVG_CONVEXFILL &&
+			(blend->srcRGB != GL_ONE || blend->dstRGB != GL_ONE_MINUS_SRC_ALPHA ||
+			 blend->srcAlpha != GL_ONE || blend->dstAlpha != GL_ONE_MINUS_SRC_ALPHA))
+			return 0;
+		if (call->pathOffset != run->pathOffset + run->pathCount)
+			return 0;
+		run->pathCount += call->pathCount;
+		return 1;
+	}
+	if (run->type == GLNVG_TRIANGLES) {
+		if (call->triangleOffset != run->triangleOffset + run->triangleCount)
+			return 0;
+		run->triangleCount += call->triangleCount;
+		return 1;
+	}
+	return 0;
+}
+
 static void glnvg__renderFlush(void* uptr)
 {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
-	int i;
+	size_t vertBase = 0;
+	int i, j;
 
 	if (gl->ncalls > 0) {
 
+		gl->stats.submittedStateChanges += glnvg__countStateChanges(gl->calls, gl->ncalls);
+		if (gl->reorder)
+			glnvg__reorderCalls(gl);
+		gl->stats.stateChanges += glnvg__countStateChanges(gl->calls, gl->ncalls);
+
 		// Setup require GL state.
 		glUseProgram(gl->shader.prog);
 
@@ -1180,7 +1853,12 @@ static void glnvg__renderFlush(void* uptr)
 		glFrontFace(GL_CCW);
 		glEnable(GL_BLEND);
 		glDisable(GL_DEPTH_TEST);
-		glDisable(GL_SCISSOR_TEST);
+		if (gl->clipRect[2] >= 0 && gl->clipRect[3] >= 0) {
+			glEnable(GL_SCISSOR_TEST);
+			glScissor(gl->clipRect[0], gl->clipRect[1], gl->clipRect[2], gl->clipRect[3]);
+		} else {
+			glDisable(GL_SCISSOR_TEST);
+		}
 		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 		glStencilMask(0xffffffff);
 		glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
@@ -1202,7 +1880,11 @@ static void glnvg__renderFlush(void* uptr)
 #if NANOVG_GL_USE_UNIFORMBUFFER
 		// Upload ubo for frag shaders
 		glBindBuffer(GL_UNIFORM_BUFFER, gl->fragBuf);
+#if NANOVG_GL_USE_STREAM_RING
+		gl->fragBase = glnvg__ringWrite(gl, &gl->fragRing, gl->uniforms, gl->nuniforms * gl->fragSize, gl->fragSize);
+#else
 		glBufferData(GL_UNIFORM_BUFFER, gl->nuniforms * gl->fragSize, gl->uniforms, GL_STREAM_DRAW);
+#endif
 #endif
 
 		// Upload vertex data
@@ -1210,11 +1892,30 @@ static void glnvg__renderFlush(void* uptr)
 		glBindVertexArray(gl->vertArr);
 #endif
 		glBindBuffer(GL_ARRAY_BUFFER, gl->vertBuf);
+#if NANOVG_GL_USE_STREAM_RING
+		vertBase = glnvg__ringWrite(gl, &gl->vertRing, gl->verts, gl->nverts * sizeof(NVGvertex), sizeof(NVGvertex));
+#else
 		glBufferData(GL_ARRAY_BUFFER, gl->nverts * sizeof(NVGvertex), gl->verts, GL_STREAM_DRAW);
+#endif
 		glEnableVertexAttribArray(0);
 		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(size_t)0);
-		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(0 + 2*sizeof(float)));
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)vertBase);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(vertBase + 2*sizeof(float)));
+
+#if NANOVG_GL_USE_INSTANCING
+		if (gl->ninstances > 0) {
+			glBindBuffer(GL_ARRAY_BUFFER, gl->instBuf);
+#if NANOVG_GL_USE_STREAM_RING
+			gl->instBase = glnvg__ringWrite(gl, &gl->instRing, gl->instances, gl->ninstances * sizeof(GLNVGinstance), sizeof(GLNVGinstance));
+#else
+			glBufferData(GL_ARRAY_BUFFER, gl->ninstances * sizeof(GLNVGinstance), gl->instances, GL_STREAM_DRAW);
+#endif
+			glBindBuffer(GL_ARRAY_BUFFER, gl->vertBuf);
+		}
+#endif
+#if defined NANOVG_GL3 || defined NANOVG_GLES3
+		glnvg__resetInstanceAttribs();
+#endif
 
 		// Set view and texture just once per frame.
 		glUniform1i(gl->shader.loc[GLNVG_LOC_TEX], 0);
@@ -1224,8 +1925,11 @@ static void glnvg__renderFlush(void* uptr)
 		glBindBuffer(GL_UNIFORM_BUFFER, gl->fragBuf);
 #endif
 
-		for (i = 0; i < gl->ncalls; i++) {
-			GLNVGcall* call = &gl->calls[i];
+		for (i = 0; i < gl->ncalls; i = j) {
+			GLNVGcall run = gl->calls[i];
+			GLNVGcall* call = &run;
+			for (j = i+1; j < gl->ncalls && glnvg__mergeCall(gl, call, &gl->calls[j]); j++)
+				gl->stats.mergedCalls++;
 			glnvg__blendFuncSeparate(gl,&call->blendFunc);
 			if (call->type == GLNVG_FILL)
 				glnvg__fill(gl, call);
@@ -1235,7 +1939,19 @@ static void glnvg__renderFlush(void* uptr)
 				glnvg__stroke(gl, call);
 			else if (call->type == GLNVG_TRIANGLES)
 				glnvg__triangles(gl, call);
+#if NANOVG_GL_USE_INSTANCING
+			else if (call->type == GLNVG_INSTANCES)
+				glnvg__instances(gl, call);
+#endif
 		}
+		gl->stats.calls += gl->ncalls;
+
+#if NANOVG_GL_USE_STREAM_RING
+		glnvg__ringFence(gl, &gl->vertRing);
+		glnvg__ringFence(gl, &gl->fragRing);
+		glnvg__ringFence(gl, &gl->instRing);
+#endif
+		gl->stats.flushes++;
 
 		glDisableVertexAttribArray(0);
 		glDisableVertexAttribArray(1);
@@ -1243,6 +1959,7 @@ static void glnvg__renderFlush(void* uptr)
 		glBindVertexArray(0);
 #endif
 		glDisable(GL_CULL_FACE);
+		glDisable(GL_SCISSOR_TEST);
 			glBindBuffer(GL_ARRAY_BUFFER, 0);
 		glUseProgram(0);
 		glnvg__bindTexture(gl, 0);
@@ -1253,6 +1970,7 @@ static void glnvg__renderFlush(void* uptr)
 	gl->npaths = 0;
 	gl->ncalls = 0;
 	gl->nuniforms = 0;
+	gl->ninstances = 0;
 }
 
 static int glnvg__maxVertCount(const NVGpath* paths, int npaths)
@@ -1342,6 +2060,21 @@ static void glnvg__vset(NVGvertex* vtx, float x, float y, float u, float v)
 	vtx->v = v;
 }
 
+// Sets the bounds of a call to those of its vertices, which include the anti-aliased fringes.
+static void glnvg__setCallBounds(GLNVGcall* call, const NVGvertex* verts, int nverts)
+{
+	int i;
+	if (nverts == 0) return;
+	call->bounds[0] = call->bounds[2] = verts[0].x;
+	call->bounds[1] = call->bounds[3] = verts[0].y;
+	for (i = 1; i < nverts; i++) {
+		call->bounds[0] = glnvg__minf(call->bounds[0], verts[i].x);
+		call->bounds[1] = glnvg__minf(call->bounds[1], verts[i].y);
+		call->bounds[2] = glnvg__maxf(call->bounds[2], verts[i].x);
+		call->bounds[3] = glnvg__maxf(call->bounds[3], verts[i].y);
+	}
+}
+
 static void glnvg__renderFill(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, float fringe,
 							  const float* bounds, const NVGpath* paths, int npaths)
 {
@@ -1349,7 +2082,7 @@ static void glnvg__renderFill(void* uptr, NVGpaint* paint, NVGcompositeOperation
 	GLNVGcall* call = glnvg__allocCall(gl);
 	NVGvertex* quad;
 	GLNVGfragUniforms* frag;
-	int i, maxverts, offset;
+	int i, maxverts, offset, first;
 
 	if (call == NULL) return;
 
@@ -1371,6 +2104,7 @@ static void glnvg__renderFill(void* uptr, NVGpaint* paint, NVGcompositeOperation
 	maxverts = glnvg__maxVertCount(paths, npaths) + call->triangleCount;
 	offset = glnvg__allocVerts(gl, maxverts);
 	if (offset == -1) goto error;
+	first = offset;
 
 	for (i = 0; i < npaths; i++) {
 		GLNVGpath* copy = &gl->paths[call->pathOffset + i];
@@ -1390,6 +2124,8 @@ static void glnvg__renderFill(void* uptr, NVGpaint* paint, NVGcompositeOperation
 		}
 	}
 
+	glnvg__setCallBounds(call, &gl->verts[first], offset - first);
+
 	// Setup uniforms for draw calls
 	if (call->type == GLNVG_FILL) {
 		// Quad
@@ -1429,7 +2165,7 @@ static void glnvg__renderStroke(void* uptr, NVGpaint* paint, NVGcompositeOperati
 {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
 	GLNVGcall* call = glnvg__allocCall(gl);
-	int i, maxverts, offset;
+	int i, maxverts, offset, first;
 
 	if (call == NULL) return;
 
@@ -1444,6 +2180,7 @@ static void glnvg__renderStroke(void* uptr, NVGpaint* paint, NVGcompositeOperati
 	maxverts = glnvg__maxVertCount(paths, npaths);
 	offset = glnvg__allocVerts(gl, maxverts);
 	if (offset == -1) goto error;
+	first = offset;
 
 	for (i = 0; i < npaths; i++) {
 		GLNVGpath* copy = &gl->paths[call->pathOffset + i];
@@ -1456,6 +2193,7 @@ static void glnvg__renderStroke(void* uptr, NVGpaint* paint, NVGcompositeOperati
 			offset += path->nstroke;
 		}
 	}
+	glnvg__setCallBounds(call, &gl->verts[first], offset - first);
 
 	if (gl->flags & NVG_STENCIL_STROKES) {
 		// Fill shader
@@ -1499,6 +2237,7 @@ static void glnvg__renderTriangles(void* uptr, NVGpaint* paint, NVGcompositeOper
 	call->triangleCount = nverts;
 
 	memcpy(&gl->verts[call->triangleOffset], verts, sizeof(NVGvertex) * nverts);
+	glnvg__setCallBounds(call, verts, nverts);
 
 	// Fill shader
 	call->uniformOffset = glnvg__allocFragUniforms(gl, 1);
@@ -1506,6 +2245,9 @@ static void glnvg__renderTriangles(void* uptr, NVGpaint* paint, NVGcompositeOper
 	frag = nvg__fragUniformPtr(gl, call->uniformOffset);
 	glnvg__convertPaint(gl, frag, paint, scissor, 1.0f, 1.0f, -1.0f);
 	frag->type = NSVG_SHADER_IMG;
+	// The triangles carry their own texture coordinates, so the paint transform is left out for
+	// the call to merge with others.
+	memset(frag->paintMat, 0, sizeof(frag->paintMat));
 
 	return;
 
@@ -1515,6 +2257,100 @@ error:
 	if (gl->ncalls > 0) gl->ncalls--;
 }
 
+static int glnvg__renderInstances(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, float fringe,
+								  const NVGpath* paths, int npaths, const float* xforms, const NVGcolor* colors, int ncolors, int ninstances)
+{
+#if NANOVG_GL_USE_INSTANCING
+	GLNVGcontext* gl = (GLNVGcontext*)uptr;
+	GLNVGcall* call;
+	int i, offset;
+
+	if (!gl->instancing) return 0;
+	if (ncolors < 0 || (ncolors > 1 && ncolors < ninstances)) return 0;
+	call = glnvg__allocCall(gl);
+	if (call == NULL) return 0;
+
+	call->type = GLNVG_INSTANCES;
+	call->pathOffset = glnvg__allocPaths(gl, npaths);
+	if (call->pathOffset == -1) goto error;
+	call->pathCount = npaths;
+	call->image = paint->image;
+	call->blendFunc = glnvg__blendCompositeOperation(compositeOperation);
+
+	// The shape is copied once, however many instances are drawn
+	offset = glnvg__allocVerts(gl, glnvg__maxVertCount(paths, npaths));
+	if (offset == -1) goto error;
+
+	for (i = 0; i < npaths; i++) {
+		GLNVGpath* copy = &gl->paths[call->pathOffset + i];
+		const NVGpath* path = &paths[i];
+		memset(copy, 0, sizeof(GLNVGpath));
+		if (path->nfill > 0) {
+			copy->fillOffset = offset;
+			copy->fillCount = path->nfill;
+			memcpy(&gl->verts[offset], path->fill, sizeof(NVGvertex) * path->nfill);
+			offset += path->nfill;
+		}
+		if (path->nstroke > 0) {
+			copy->strokeOffset = offset;
+			copy->strokeCount = path->nstroke;
+			memcpy(&gl->verts[offset], path->stroke, sizeof(NVGvertex) * path->nstroke);
+			offset += path->nstroke;
+		}
+	}
+
+	if (gl->ninstances+ninstances > gl->cinstances) {
+		GLNVGinstance* instances;
+		int cinstances = glnvg__maxi(gl->ninstances + ninstances, 256) + gl->cinstances/2; // 1.5x Overallocate
+		instances = (GLNVGinstance*)realloc(gl->instances, sizeof(GLNVGinstance) * cinstances);
+		if (instances == NULL) goto error;
+		gl->instances = instances;
+		gl->cinstances = cinstances;
+	}
+	call->instanceOffset = gl->ninstances;
+	call->instanceCount = ninstances;
+	gl->ninstances += ninstances;
+
+	for (i = 0; i < ninstances; i++) {
+		GLNVGinstance* instance = &gl->instances[call->instanceOffset + i];
+		const float* t = &xforms[i*6];
+		NVGcolor color = ncolors > 0 ? colors[ncolors == 1 ? 0 : i] : nvgRGBAf(1, 1, 1, 1);
+		instance->xformX[0] = t[0]; instance->xformX[1] = t[2]; instance->xformX[2] = t[4];
+		instance->xformY[0] = t[1]; instance->xformY[1] = t[3]; instance->xformY[2] = t[5];
+		instance->color[0] = color.r * color.a;
+		instance->color[1] = color.g * color.a;
+		instance->color[2] = color.b * color.a;
+		instance->color[3] = color.a;
+	}
+
+	// Fill shader
+	call->uniformOffset = glnvg__allocFragUniforms(gl, 1);
+	if (call->uniformOffset == -1) goto error;
+	glnvg__convertPaint(gl, nvg__fragUniformPtr(gl, call->uniformOffset), paint, scissor, fringe, fringe, -1.0f);
+
+	return 1;
+
+error:
+	// We get here if call alloc was ok, but something else is not.
+	// Roll back the last call to prevent drawing it.
+	if (gl->ncalls > 0) gl->ncalls--;
+	return 0;
+#else
+	NVG_NOTUSED(uptr);
+	NVG_NOTUSED(paint);
+	NVG_NOTUSED(compositeOperation);
+	NVG_NOTUSED(scissor);
+	NVG_NOTUSED(fringe);
+	NVG_NOTUSED(paths);
+	NVG_NOTUSED(npaths);
+	NVG_NOTUSED(xforms);
+	NVG_NOTUSED(colors);
+	NVG_NOTUSED(ncolors);
+	NVG_NOTUSED(ninstances);
+	return 0;
+#endif
+}
+
 static void glnvg__renderDelete(void* uptr)
 {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
@@ -1533,6 +2369,19 @@ static void glnvg__renderDelete(void* uptr)
 #endif
 	if (gl->vertBuf != 0)
 		glDeleteBuffers(1, &gl->vertBuf);
+#if NANOVG_GL_USE_INSTANCING
+	if (gl->instBuf != 0)
+		glDeleteBuffers(1, &gl->instBuf);
+#endif
+#if NANOVG_GL_USE_PIXEL_BUFFER
+	if (gl->unpackBuf != 0)
+		glDeleteBuffers(1, &gl->unpackBuf);
+#endif
+#if NANOVG_GL_USE_STREAM_RING
+	glnvg__ringDeleteFences(&gl->vertRing);
+	glnvg__ringDeleteFences(&gl->fragRing);
+	glnvg__ringDeleteFences(&gl->instRing);
+#endif
 
 	for (i = 0; i < gl->ntextures; i++) {
 		if (gl->textures[i].tex != 0 && (gl->textures[i].flags & NVG_IMAGE_NODELETE) == 0)
@@ -1543,7 +2392,15 @@ static void glnvg__renderDelete(void* uptr)
 	free(gl->paths);
 	free(gl->verts);
 	free(gl->uniforms);
+	free(gl->instances);
 	free(gl->calls);
+#if NANOVG_GL_USE_MULTI_DRAW
+	free(gl->drawFirsts);
+	free(gl->drawCounts);
+#endif
+	free(gl->order);
+	free(gl->sortCalls);
+	free(gl->sortPaths);
 
 	free(gl);
 }
@@ -1568,20 +2425,26 @@ NVGcontext* nvgCreateGLES3(int flags)
 	memset(&params, 0, sizeof(params));
 	params.renderCreate = glnvg__renderCreate;
 	params.renderCreateTexture = glnvg__renderCreateTexture;
+	params.renderCreateTextureLevels = glnvg__renderCreateTextureLevels;
 	params.renderDeleteTexture = glnvg__renderDeleteTexture;
 	params.renderUpdateTexture = glnvg__renderUpdateTexture;
+	params.renderUpdateTextureRegion = glnvg__renderUpdateTextureRegion;
 	params.renderGetTextureSize = glnvg__renderGetTextureSize;
+	params.renderGetTextureFormat = glnvg__renderGetTextureFormat;
 	params.renderViewport = glnvg__renderViewport;
 	params.renderCancel = glnvg__renderCancel;
 	params.renderFlush = glnvg__renderFlush;
 	params.renderFill = glnvg__renderFill;
 	params.renderStroke = glnvg__renderStroke;
 	params.renderTriangles = glnvg__renderTriangles;
+	params.renderInstances = glnvg__renderInstances;
 	params.renderDelete = glnvg__renderDelete;
 	params.userPtr = gl;
 	params.edgeAntiAlias = flags & NVG_ANTIALIAS ? 1 : 0;
 
 	gl->flags = flags;
+	gl->clipRect[2] = -1;
+	gl->clipRect[3] = -1;
 
 	ctx = nvgCreateInternal(&params);
 	if (ctx == NULL) goto error;
@@ -1646,4 +2509,64 @@ GLuint nvglImageHandleGLES3(NVGcontext* ctx, int image)
 	return tex->tex;
 }
 
+#if defined NANOVG_GL2
+void nvglSetClipRectGL2(NVGcontext* ctx, int x, int y, int w, int h)
+#elif defined NANOVG_GL3
+void nvglSetClipRectGL3(NVGcontext* ctx, int x, int y, int w, int h)
+#elif defined NANOVG_GLES2
+void nvglSetClipRectGLES2(NVGcontext* ctx, int x, int y, int w, int h)
+#elif defined NANOVG_GLES3
+void nvglSetClipRectGLES3(NVGcontext* ctx, int x, int y, int w, int h)
+#endif
+{
+	GLNVGcontext* gl = (GLNVGcontext*)nvgInternalParams(ctx)->userPtr;
+	gl->clipRect[0] = x;
+	gl->clipRect[1] = y;
+	gl->clipRect[2] = w;
+	gl->clipRect[3] = h;
+}
+
+#if defined NANOVG_GL3
+void nvglSetStreamBufferSizeGL3(NVGcontext* ctx, int size)
+#elif defined NANOVG_GLES3
+void nvglSetStreamBufferSizeGLES3(NVGcontext* ctx, int size)
+#endif
+#if defined NANOVG_GL3 || defined NANOVG_GLES3
+{
+#if NANOVG_GL_USE_STREAM_RING
+	GLNVGcontext* gl = (GLNVGcontext*)nvgInternalParams(ctx)->userPtr;
+	gl->streamSize = size > 0 ? size : NANOVG_GL_STREAM_BUFFER_SIZE;
+	// Reallocated on the next write.
+	gl->vertRing.size = 0;
+	gl->fragRing.size = 0;
+	gl->instRing.size = 0;
+#else
+	NVG_NOTUSED(ctx);
+	NVG_NOTUSED(size);
+#endif
+}
+
+#if defined NANOVG_GL3
+void nvglGetStatsGL3(NVGcontext* ctx, NVGLstats* stats, int reset)
+#elif defined NANOVG_GLES3
+void nvglGetStatsGLES3(NVGcontext* ctx, NVGLstats* stats, int reset)
+#endif
+{
+	GLNVGcontext* gl = (GLNVGcontext*)nvgInternalParams(ctx)->userPtr;
+	*stats = gl->stats;
+	if (reset)
+		memset(&gl->stats, 0, sizeof(gl->stats));
+}
+
+#if defined NANOVG_GL3
+void nvglSetReorderCallsGL3(NVGcontext* ctx, int enable)
+#elif defined NANOVG_GLES3
+void nvglSetReorderCallsGLES3(NVGcontext* ctx, int enable)
+#endif
+{
+	GLNVGcontext* gl = (GLNVGcontext*)nvgInternalParams(ctx)->userPtr;
+	gl->reorder = enable;
+}
+#endif
+
 #endif /* NANOVG_GL_IMPLEMENTATION */
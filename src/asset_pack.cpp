@@ -0,0 +1,357 @@
+#include "dana/asset_pack.h"
+
+#include "dana/types.h"
+#include "dana/util.h"
+
+#include <nanovg/stb_image.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+// Keeps windows.h from defining min and max macros, which break std::min and
+// std::max
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dana {
+
+static constexpr char pack_magic[8]{'D', 'A', 'N', 'A', 'P', 'A', 'C', 'K'};
+static constexpr uint32_t pack_version{1};
+static constexpr uint32_t max_level_count{32};
+
+struct PackHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t image_count;
+};
+
+// The levels of an image follow each other, starting at the data offset
+struct PackIndexEntry {
+  uint32_t name_offset;
+  uint32_t name_size;
+  uint32_t channels;
+  uint32_t width;
+  uint32_t height;
+  uint32_t image_flags;
+  uint32_t level_count;
+  uint32_t reserved;
+  uint64_t data_offset;
+};
+
+static std::size_t getLevelSize(const int width, const int height,
+                                const int channels) noexcept {
+  return static_cast<std::size_t>(width) * height * channels;
+}
+
+static std::size_t alignToPage(const std::size_t offset) noexcept {
+  return (offset + AssetPack::page_size - 1) / AssetPack::page_size *
+         AssetPack::page_size;
+}
+
+// Averages each 2x2 block of pixels, repeating the last row or column of odd
+// sizes
+static std::vector<unsigned char> halve(
+    const std::vector<unsigned char>& pixels, const int width,
+    const int height, const int channels) {
+  const int new_width{std::max(width / 2, 1)};
+  const int new_height{std::max(height / 2, 1)};
+  std::vector<unsigned char> result(getLevelSize(new_width, new_height,
+                                                 channels));
+
+  for (int y = 0; y < new_height; ++y) {
+    const int top{std::min(y * 2, height - 1)};
+    const int bottom{std::min(y * 2 + 1, height - 1)};
+
+    for (int x = 0; x < new_width; ++x) {
+      const int left{std::min(x * 2, width - 1)};
+      const int right{std::min(x * 2 + 1, width - 1)};
+
+      for (int c = 0; c < channels; ++c) {
+        const auto pixel = [&](const int row, const int column) {
+          return static_cast<unsigned int>(
+              pixels[(row * width + column) * channels + c]);
+        };
+        const unsigned int sum{pixel(top, left) + pixel(top, right) +
+                               pixel(bottom, left) + pixel(bottom, right)};
+        result[(y * new_width + x) * channels + c] =
+            static_cast<unsigned char>((sum + 2) / 4);
+      }
+    }
+  }
+  return result;
+}
+
+AssetPack::AssetPack(const std::string& filename) noexcept {
+#ifdef _WIN32
+  const auto file{CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              nullptr)};
+
+  if (file == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  LARGE_INTEGER size;
+
+  if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+    const auto mapping{
+        CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+
+    if (mapping != nullptr) {
+      m_data = static_cast<const unsigned char*>(
+          MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+      m_size = m_data != nullptr ? static_cast<std::size_t>(size.QuadPart) : 0;
+      CloseHandle(mapping);
+    }
+  }
+  CloseHandle(file);
+#else
+  const int file{open(filename.c_str(), O_RDONLY)};
+
+  if (file < 0) {
+    return;
+  }
+  struct stat status;
+
+  if (fstat(file, &status) == 0 && status.st_size > 0) {
+    void* data{mmap(nullptr, static_cast<std::size_t>(status.st_size),
+                    PROT_READ, MAP_PRIVATE, file, 0)};
+
+    if (data != MAP_FAILED) {
+      m_data = static_cast<const unsigned char*>(data);
+      m_size = static_cast<std::size_t>(status.st_size);
+    }
+  }
+  ::close(file);
+#endif
+
+  if (m_data != nullptr && !readIndex()) {
+    close();
+  }
+}
+
+AssetPack::~AssetPack() noexcept {
+  close();
+}
+
+bool AssetPack::isOpen() const noexcept {
+  return m_data != nullptr;
+}
+
+std::size_t AssetPack::getImageCount() const noexcept {
+  return m_images.size();
+}
+
+std::vector<std::string> AssetPack::getImageNames() const {
+  std::vector<std::string> names;
+  names.reserve(m_images.size());
+
+  for (const auto& image : m_images) {
+    names.push_back(image.first);
+  }
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+const PackedImage* AssetPack::find(const std::string& name) const noexcept {
+  const auto image{m_images.find(name)};
+  return image != m_images.end() ? &image->second : nullptr;
+}
+
+bool AssetPack::readIndex() noexcept {
+  PackHeader header;
+
+  if (m_size < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, m_data, sizeof(header));
+
+  if (std::memcmp(header.magic, pack_magic, sizeof(pack_magic)) != 0 ||
+      header.version != pack_version ||
+      header.image_count >
+          (m_size - sizeof(header)) / sizeof(PackIndexEntry)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < header.image_count; ++i) {
+    PackIndexEntry entry;
+    std::memcpy(&entry, m_data + sizeof(header) + i * sizeof(entry),
+                sizeof(entry));
+
+    if ((entry.channels != 1 && entry.channels != 4) || entry.width == 0 ||
+        entry.height == 0 || entry.width > INT32_MAX ||
+        entry.height > INT32_MAX || entry.level_count == 0 ||
+        entry.level_count > max_level_count ||
+        entry.name_offset > m_size ||
+        entry.name_size > m_size - entry.name_offset) {
+      return false;
+    }
+    PackedImage image;
+    image.format =
+        entry.channels == 1 ? PixelFormat::ALPHA : PixelFormat::RGBA;
+    image.width = static_cast<int>(entry.width);
+    image.height = static_cast<int>(entry.height);
+    image.image_flags = static_cast<int>(entry.image_flags);
+
+    auto offset{entry.data_offset};
+    int width{image.width};
+    int height{image.height};
+
+    for (uint32_t level = 0; level < entry.level_count; ++level) {
+      const auto size{getLevelSize(width, height, entry.channels)};
+
+      if (offset > m_size || size > m_size - offset) {
+        return false;
+      }
+      image.levels.push_back(m_data + offset);
+      offset += size;
+      width = std::max(width / 2, 1);
+      height = std::max(height / 2, 1);
+    }
+    m_images.emplace(
+        std::string(reinterpret_cast<const char*>(m_data + entry.name_offset),
+                    entry.name_size),
+        std::move(image));
+  }
+  return true;
+}
+
+void AssetPack::close() noexcept {
+  if (m_data != nullptr) {
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+#else
+    munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+  }
+  m_data = nullptr;
+  m_size = 0;
+  m_images.clear();
+}
+
+bool AssetPackWriter::addImage(const std::string& name,
+                               const std::string& filename,
+                               const AssetPackOptions& options) {
+  const int channels{options.format == PixelFormat::ALPHA ? 1 : 4};
+  int width{0};
+  int height{0};
+  int components{0};
+  const c_unique_ptr<unsigned char> pixels{
+      stbi_load(filename.c_str(), &width, &height, &components, channels),
+      [](unsigned char* ptr) { stbi_image_free(ptr); }};
+
+  if (!pixels) {
+    return false;
+  }
+  addImage(name, width, height, pixels.get(), options);
+  return true;
+}
+
+AssetPackWriter& AssetPackWriter::addImage(const std::string& name,
+                                           const int width, const int height,
+                                           const unsigned char* pixels,
+                                           const AssetPackOptions& options) {
+  const int channels{options.format == PixelFormat::ALPHA ? 1 : 4};
+  Image image{name, options.format, width, height, 0, {}};
+  image.levels.emplace_back(pixels,
+                            pixels + getLevelSize(width, height, channels));
+
+  if (options.premultiply) {
+    auto& level{image.levels.front()};
+
+    for (std::size_t i = 0; channels == 4 && i < level.size(); i += 4) {
+      const unsigned int alpha{level[i + 3]};
+
+      for (std::size_t j = i; j < i + 3; ++j) {
+        level[j] = static_cast<unsigned char>((level[j] * alpha + 127) / 255);
+      }
+    }
+    image.image_flags |= IMAGE_PREMULTIPLIED;
+  }
+  if (options.mipmaps) {
+    // Mip levels are averaged after premultiplying, so transparent pixels do
+    // not bleed their color into the smaller levels
+    for (int w = width, h = height; w > 1 || h > 1;
+         w = std::max(w / 2, 1), h = std::max(h / 2, 1)) {
+      image.levels.push_back(halve(image.levels.back(), w, h, channels));
+    }
+    image.image_flags |= IMAGE_GENERATE_MIPMAPS;
+  }
+  m_images.push_back(std::move(image));
+  return *this;
+}
+
+std::size_t AssetPackWriter::getImageCount() const noexcept {
+  return m_images.size();
+}
+
+bool AssetPackWriter::write(const std::string& filename) const {
+  PackHeader header{{}, pack_version, static_cast<uint32_t>(m_images.size())};
+  std::memcpy(header.magic, pack_magic, sizeof(pack_magic));
+
+  // The index is followed by the names, and then the pixels of each image
+  std::vector<PackIndexEntry> index;
+  std::string names;
+  auto name_offset{static_cast<uint32_t>(
+      sizeof(header) + m_images.size() * sizeof(PackIndexEntry))};
+
+  for (const auto& image : m_images) {
+    names += image.name;
+  }
+  auto data_offset{alignToPage(name_offset + names.size())};
+
+  for (const auto& image : m_images) {
+    const PackIndexEntry entry{
+        name_offset,
+        static_cast<uint32_t>(image.name.size()),
+        image.format == PixelFormat::ALPHA ? 1u : 4u,
+        static_cast<uint32_t>(image.width),
+        static_cast<uint32_t>(image.height),
+        static_cast<uint32_t>(image.image_flags),
+        static_cast<uint32_t>(image.levels.size()),
+        0,
+        data_offset};
+    index.push_back(entry);
+    name_offset += entry.name_size;
+
+    for (const auto& level : image.levels) {
+      data_offset += level.size();
+    }
+    data_offset = alignToPage(data_offset);
+  }
+  std::ofstream file(filename, std::ios::binary);
+
+  if (!file) {
+    return false;
+  }
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(index.data()),
+             static_cast<std::streamsize>(index.size() *
+                                          sizeof(PackIndexEntry)));
+  file.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+  for (std::size_t i = 0; i < m_images.size(); ++i) {
+    const std::vector<char> padding(
+        index[i].data_offset - static_cast<std::size_t>(file.tellp()), 0);
+    file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+    for (const auto& level : m_images[i].levels) {
+      file.write(reinterpret_cast<const char*>(level.data()),
+                 static_cast<std::streamsize>(level.size()));
+    }
+  }
+  return static_cast<bool>(file);
+}
+}  // namespace dana
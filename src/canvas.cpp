@@ -5,7 +5,11 @@
 #include <SDL.h>
 
 #include <dana/canvas.h>
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
 
 namespace dana {
 
@@ -28,26 +32,18 @@ static MouseClickTypes getMouseClickType(const uint8_t clicks) noexcept;
 static MouseWheelDirections getMouseWheelDirection(
     const uint32_t direction) noexcept;
 
-Canvas::Canvas(const int width, const int height, const std::string& title) {
-  constexpr const Uint32 sdl_flags{SDL_INIT_VIDEO};
-  constexpr const Uint32 window_flags{SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE |
-                                      SDL_WINDOW_HIDDEN |
-                                      SDL_WINDOW_ALLOW_HIGHDPI};
-
-  SDL_Init(sdl_flags);
+Canvas::Canvas(const int width, const int height, const std::string& title)
+    : Canvas(std::make_shared<Device>(), width, height, title) {}
 
-  // NOTE: For now only hard code GL-version to 3.1
-  SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
-  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
-  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+Canvas::Canvas(const int width, const int height, HeadlessMode)
+    : Canvas(std::make_shared<Device>(headless), width, height, headless) {}
 
-  SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 8);
-  SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 8);
-  SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 8);
-  SDL_GL_SetAttribute(SDL_GL_ALPHA_SIZE, 8);
-  SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, 8);
-  SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
-  SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+Canvas::Canvas(const std::shared_ptr<Device>& device, const int width,
+               const int height, const std::string& title)
+    : m_device{device} {
+  constexpr const Uint32 window_flags{SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN |
+                                      SDL_WINDOW_RESIZABLE |
+                                      SDL_WINDOW_ALLOW_HIGHDPI};
 
   m_window = c_unique_ptr<SDL_Window>(
       SDL_CreateWindow(title.c_str(), SDL_WINDOWPOS_CENTERED,
@@ -57,73 +53,424 @@ Canvas::Canvas(const int width, const int height, const std::string& title) {
   if (nullptr == m_window) {
     throw std::runtime_error("Unable to initialize SDL window");
   }
-  m_gl_context =
-      c_unique_ptr<void>(SDL_GL_CreateContext(m_window.get()),
-                         [](auto* ptr) { SDL_GL_DeleteContext(ptr); });
+  m_window_id = SDL_GetWindowID(m_window.get());
+  m_device->addCanvas(this);
+}
+
+Canvas::Canvas(const std::shared_ptr<Device>& device, const int width,
+               const int height, HeadlessMode)
+    : m_device{device} {
+  m_device->makeCurrent(nullptr);
+  m_framebuffer = std::make_unique<Framebuffer>(width, height);
+  m_device->addCanvas(this);
+}
 
-  glewExperimental = GL_TRUE;
+Canvas::~Canvas() noexcept {
+  m_device->removeCanvas(this);
 
-  if (glewInit() != GLEW_OK) {
-    throw std::runtime_error("Unable to initialize Glew");
-  }
+  // GL resources have to be released while the context is current, and not on
+  // the window that is about to be destroyed
+  m_device->makeCurrent(nullptr);
 
-  glViewport(0, 0, width, height);
+  for (const auto& layer : m_layers) {
+    layer->m_changed_callback = nullptr;
+    layer->release(m_device->getFramebufferPool());
+  }
+  m_readback.reset();
+  m_back_buffer.reset();
+  m_framebuffer.reset();
+  m_window.reset();
 }
 
-Canvas::~Canvas() noexcept { SDL_Quit(); }
-
 Canvas& Canvas::setClearColor(const Color& clear_color) noexcept {
   m_clear_color = clear_color;
+  damageAll();
   return *this;
 }
 
 Canvas& Canvas::onNewFrame(const DrawCallback& draw_callback) noexcept {
+  m_draw_callback = [draw_callback](Pencil& pencil, float) {
+    draw_callback(pencil);
+  };
+  return *this;
+}
+
+Canvas& Canvas::onNewFrame(
+    const InterpolatedDrawCallback& draw_callback) noexcept {
   m_draw_callback = draw_callback;
   return *this;
 }
 
+Canvas& Canvas::onParallelFrame(const std::size_t chunk_count,
+                                const RecordCallback& record_callback) {
+  m_record_callback = record_callback;
+  m_pictures.resize(record_callback ? chunk_count : 0);
+  return *this;
+}
+
+Canvas& Canvas::onUpdate(const UpdateCallback& update_callback) noexcept {
+  m_update_callback = update_callback;
+  m_timestep.reset();
+  return *this;
+}
+
+Canvas& Canvas::setUpdateRate(const double update_rate) noexcept {
+  m_timestep.setUpdateRate(update_rate);
+  return *this;
+}
+
+Canvas& Canvas::setMaxUpdateSteps(const std::size_t max_steps) noexcept {
+  m_timestep.setMaxSteps(max_steps);
+  return *this;
+}
+
+const FixedTimestep& Canvas::getTimestep() const noexcept {
+  return m_timestep;
+}
+
 void Canvas::show() noexcept {
-  SDL_ShowWindow(m_window.get());
+  if (isHeadless()) {
+    return;
+  }
+  m_device->run();
+}
+
+void Canvas::renderFrame() noexcept {
+  const auto begin_time{std::chrono::steady_clock::now()};
+
+  m_device->pollEvents();
+  drawFrame(begin_time);
+}
+
+bool Canvas::isHeadless() const noexcept { return nullptr != m_framebuffer; }
+
+Device& Canvas::getDevice() const noexcept { return *m_device; }
+
+void Canvas::drawFrame(const std::chrono::steady_clock::time_point begin_time,
+                       const bool synchronize_swap) noexcept {
+  auto phase_time{begin_time};
+
+  const auto endPhase = [&](const FramePhases phase) {
+    const auto now{std::chrono::steady_clock::now()};
+    m_statistics.record(phase, now - phase_time);
+    phase_time = now;
+  };
 
-  SDL_Event event;
+  m_redraw.frameRendered(begin_time);
+
+  endPhase(FramePhases::POLL_EVENTS);
+
+  float alpha{1.0f};
+
+  if (m_update_callback) {
+    const auto steps{m_timestep.advance(begin_time)};
+    const auto step_seconds{m_timestep.getStepSeconds()};
+
+    for (std::size_t i = 0; i < steps; ++i) {
+      m_update_callback(step_seconds);
+    }
+    alpha = m_timestep.getAlpha();
+  }
+  endPhase(FramePhases::UPDATE);
 
   int d_width{0};
   int d_height{0};
   int w_width{0};
   int w_height{0};
 
-  std::chrono::steady_clock::time_point begin_time;
+  m_device->makeCurrent(m_window.get());
 
-  Pencil pencil;
+  if (isHeadless()) {
+    std::tie(d_width, d_height) = m_framebuffer->getSize();
+    std::tie(w_width, w_height) = m_framebuffer->getSize();
+  } else {
+    SDL_GL_GetDrawableSize(m_window.get(), &d_width, &d_height);
+    SDL_GetWindowSize(m_window.get(), &w_width, &w_height);
+  }
+  const auto pixel_ratio =
+      static_cast<float>(d_width) / static_cast<float>(w_width);
 
-  while (m_show) {
-    begin_time = std::chrono::steady_clock::now();
+  auto& pencil{m_device->getPencil()};
 
-    pollEvents(event);
-    clearWindow();
+  if (m_device->m_image_loader) {
+    m_device->m_image_loader->upload();
+  }
+  renderLayers(pencil, pixel_ratio);
+  endPhase(FramePhases::LAYERS);
 
-    SDL_GL_GetDrawableSize(m_window.get(), &d_width, &d_height);
-    SDL_GetWindowSize(m_window.get(), &w_width, &w_height);
+  if (isHeadless()) {
+    m_framebuffer->bind();
+  } else {
+    Framebuffer::unbind();
+  }
+  updateRedrawArea(d_width, d_height, w_width, w_height);
+
+  const bool redraw{m_redraw_area.width > 0 && m_redraw_area.height > 0};
 
-    glViewport(0, 0, d_width, d_height);
+  if (redraw && m_partial_redraw) {
+    setClipRect(pencil, pixel_ratio, d_height);
+  }
+  if (redraw) {
+    clearWindow();
+  }
+  glViewport(0, 0, d_width, d_height);
 
-    const auto pixel_ratio =
-        static_cast<float>(d_width) / static_cast<float>(w_width);
+  endPhase(FramePhases::CLEAR);
+
+  // Call user defined draw function
+  if (redraw) {
+    pencil.beginFrame(static_cast<float>(w_width),
+                      static_cast<float>(w_height), pixel_ratio);
+    compositeLayers(pencil, false);
+    m_draw_callback(pencil, alpha);
+    drawPictures(pencil);
+    compositeLayers(pencil, true);
+  }
+  endPhase(FramePhases::DRAW);
 
-    // Call user defined draw function
-    pencil.beginFrame(static_cast<float>(w_width), static_cast<float>(w_height),
-                      pixel_ratio);
-    m_draw_callback(pencil);
+  if (redraw) {
     pencil.endFrame();
+  }
+  if (m_partial_redraw) {
+    glDisable(GL_SCISSOR_TEST);
+    pencil.resetClipRect();
+
+    if (!isHeadless()) {
+      m_back_buffer->blitToWindow();
+    }
+  }
+  endPhase(FramePhases::FLUSH);
+
+  if (m_readback) {
+    m_readback->queue(0, 0, d_width, d_height, m_frame_count);
+    m_readback->poll();
+  }
+  endPhase(FramePhases::READBACK);
+
+  if (!isHeadless()) {
+    m_device->swapWindow(m_window.get(), synchronize_swap);
+  }
+  endPhase(FramePhases::SWAP);
+
+  m_statistics.record(FramePhases::TOTAL, phase_time - begin_time);
+  ++m_frame_count;
+}
+
+Canvas& Canvas::onFrameReadback(const ReadbackCallback& readback_callback,
+                                const std::size_t buffer_count) {
+  m_readback_callback = readback_callback;
+  m_readback_buffers = buffer_count;
+  updateReadback();
+  return *this;
+}
+
+Canvas& Canvas::setFrameExporter(
+    const std::shared_ptr<FrameExporter>& exporter) {
+  m_frame_exporter = exporter;
+  updateReadback();
+  return *this;
+}
+
+void Canvas::updateReadback() {
+  flushReadbacks();
+  m_readback.reset();
+
+  if (m_readback_callback || m_frame_exporter) {
+    m_readback = std::make_unique<Readback>(
+        m_readback_buffers, [this](const FramePixels& pixels) {
+          if (m_readback_callback) {
+            m_readback_callback(pixels);
+          }
+          if (m_frame_exporter) {
+            m_frame_exporter->submit(pixels);
+          }
+        });
+  }
+}
+
+void Canvas::flushReadbacks() noexcept {
+  if (m_readback) {
+    m_readback->flush();
+  }
+}
+
+uint64_t Canvas::getFrameCount() const noexcept { return m_frame_count; }
+
+Canvas& Canvas::setTargetFrameRate(const double frame_rate) noexcept {
+  m_device->setTargetFrameRate(frame_rate);
+  return *this;
+}
+
+Canvas& Canvas::setSwapInterval(const SwapIntervals swap_interval) noexcept {
+  m_device->makeCurrent(m_window.get());
+  m_device->setSwapInterval(swap_interval);
+  return *this;
+}
+
+SwapIntervals Canvas::getSwapInterval() const noexcept {
+  return m_device->getSwapInterval();
+}
+
+Canvas& Canvas::setUncapped() noexcept {
+  m_device->setUncapped();
+  return *this;
+}
+
+Canvas& Canvas::setThreadedRendering(const bool enabled) noexcept {
+  m_device->setThreadedRendering(enabled);
+  return *this;
+}
+
+Canvas& Canvas::setRedrawMode(const RedrawModes redraw_mode) noexcept {
+  m_redraw.setRedrawMode(redraw_mode);
+  invalidate();
+  return *this;
+}
+
+Canvas& Canvas::setRedrawInterval(
+    const std::chrono::milliseconds redraw_interval) noexcept {
+  m_redraw.setRedrawInterval(redraw_interval);
+  return *this;
+}
+
+void Canvas::invalidate() noexcept {
+  damageAll();
+  m_redraw.invalidate();
+}
+
+void Canvas::invalidate(const Rect& rect) noexcept {
+  {
+    std::lock_guard<std::mutex> lock(m_damage_mutex);
+    m_damage.add(rect);
+  }
+  m_redraw.invalidate();
+}
+
+Canvas& Canvas::setPartialRedraw(const bool enabled) noexcept {
+  m_partial_redraw = enabled;
+
+  if (!enabled) {
+    m_device->makeCurrent(m_window.get());
+    m_back_buffer.reset();
+  }
+  invalidate();
+  return *this;
+}
+
+bool Canvas::isPartialRedraw() const noexcept { return m_partial_redraw; }
+
+Rect Canvas::getRedrawArea() const noexcept { return m_redraw_area; }
+
+std::shared_ptr<Layer> Canvas::createLayer(const int width,
+                                           const int height) {
+  auto layer{std::make_shared<Layer>(width, height)};
+  layer->m_changed_callback = [this] { invalidate(); };
+  m_layers.push_back(layer);
+  invalidate();
+  return layer;
+}
+
+void Canvas::removeLayer(const std::shared_ptr<Layer>& layer) noexcept {
+  const auto it{std::find(m_layers.begin(), m_layers.end(), layer)};
+
+  if (it == m_layers.end()) {
+    return;
+  }
+  m_device->makeCurrent(m_window.get());
+  layer->m_changed_callback = nullptr;
+  layer->release(m_device->getFramebufferPool());
+  m_layers.erase(it);
+  invalidate();
+}
+
+void Canvas::drawPictures(Pencil& pencil) {
+  if (!m_record_callback) {
+    return;
+  }
+  // Pictures keep their buffers, so recording does not allocate once they
+  // have grown to fit a frame
+  m_device->getThreadPool().parallelFor(
+      m_pictures.size(), [this](const std::size_t chunk) {
+        m_record_callback(m_pictures[chunk].clear(), chunk);
+      });
+
+  for (const auto& picture : m_pictures) {
+    pencil.save();
+    picture.replay(pencil);
+    pencil.restore();
+  }
+}
+
+void Canvas::renderLayers(Pencil& pencil, const float pixel_ratio) {
+  std::stable_sort(m_layers.begin(), m_layers.end(),
+                   [](const auto& first, const auto& second) {
+                     return first->getZOrder() < second->getZOrder();
+                   });
+
+  for (const auto& layer : m_layers) {
+    if (layer->render(pencil, m_device->getFramebufferPool(), pixel_ratio)) {
+      damageAll();
+    }
+  }
+}
+
+void Canvas::compositeLayers(Pencil& pencil, const bool above) const
+    noexcept {
+  for (const auto& layer : m_layers) {
+    if ((layer->getZOrder() >= 0) == above) {
+      layer->composite(pencil);
+    }
+  }
+}
+
+void Canvas::damageAll() noexcept {
+  std::lock_guard<std::mutex> lock(m_damage_mutex);
+  m_damage.addAll();
+}
+
+bool Canvas::isFrameDue(
+    const std::chrono::steady_clock::time_point now) const noexcept {
+  return m_redraw.isFrameDue(now);
+}
 
-    SDL_GL_SwapWindow(m_window.get());
+void Canvas::updateRedrawArea(const int d_width, const int d_height,
+                              const int w_width, const int w_height) {
+  const Rect area{0, 0, static_cast<float>(w_width),
+                  static_cast<float>(w_height)};
 
-    m_performance = std::chrono::duration_cast<std::chrono::milliseconds>(
-                        std::chrono::steady_clock::now() - begin_time)
-                        .count();
+  if (!m_partial_redraw) {
+    m_redraw_area = area;
+    return;
+  }
+  std::lock_guard<std::mutex> lock(m_damage_mutex);
 
-    SDL_Delay(10);
+  // Windows render into a buffer that keeps its content between frames, as
+  // the content of the back buffer is undefined after a swap
+  if (!isHeadless()) {
+    if (nullptr == m_back_buffer ||
+        m_back_buffer->getSize() != std::make_pair(d_width, d_height)) {
+      m_back_buffer = std::make_unique<Framebuffer>(d_width, d_height);
+      m_damage.addAll();
+    }
+    m_back_buffer->bind();
   }
+  m_redraw_area = m_damage.getBounds(area);
+  m_damage.clear();
+}
+
+void Canvas::setClipRect(Pencil& pencil, const float pixel_ratio,
+                         const int d_height) const noexcept {
+  // Round outwards to whole pixels and flip to OpenGL's bottom-left origin
+  const auto left{static_cast<int>(std::floor(m_redraw_area.x * pixel_ratio))};
+  const auto top{static_cast<int>(std::floor(m_redraw_area.y * pixel_ratio))};
+  const auto right{static_cast<int>(
+      std::ceil((m_redraw_area.x + m_redraw_area.width) * pixel_ratio))};
+  const auto bottom{static_cast<int>(
+      std::ceil((m_redraw_area.y + m_redraw_area.height) * pixel_ratio))};
+
+  glEnable(GL_SCISSOR_TEST);
+  glScissor(left, d_height - bottom, right - left, bottom - top);
+  pencil.setClipRect(left, d_height - bottom, right - left, bottom - top);
 }
 
 void Canvas::clearWindow() const noexcept {
@@ -132,13 +479,39 @@ void Canvas::clearWindow() const noexcept {
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 }
 
-void Canvas::pollEvents(SDL_Event& event) noexcept {
-  while (SDL_PollEvent(&event)) {
-    m_event_callback(convertEvent(event));
-    if (event.type == SDL_QUIT) {
+int Canvas::getEventTimeout(
+    const std::chrono::steady_clock::time_point now) const noexcept {
+  return m_redraw.getEventTimeout(now);
+}
+
+void Canvas::handleEvent(const SDL_Event& event) noexcept {
+  switch (event.type) {
+    case SDL_WINDOWEVENT:
+      switch (event.window.event) {
+        case SDL_WINDOWEVENT_CLOSE:
+          // Other windows of the device keep running
+          m_show = false;
+          break;
+        default:
+          if (m_redraw.handleWindowEvent(getWindowEvent(event.window.event))) {
+            damageAll();
+          }
+          break;
+      }
+      break;
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+    case SDL_MOUSEMOTION:
+    case SDL_MOUSEWHEEL:
+      m_redraw.handleInputEvent();
+      break;
+    case SDL_QUIT:
       m_show = false;
-    }
+      break;
   }
+  m_event_callback(convertEvent(event));
 }
 
 Canvas& Canvas::onEvent(const EventCallback& event_callback) noexcept {
@@ -146,7 +519,20 @@ Canvas& Canvas::onEvent(const EventCallback& event_callback) noexcept {
   return *this;
 }
 
-long Canvas::getPerformance() const noexcept { return m_performance; }
+long Canvas::getPerformance() const noexcept {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             m_statistics.getLast(FramePhases::TOTAL))
+      .count();
+}
+
+const FrameStatistics& Canvas::getFrameStatistics() const noexcept {
+  return m_statistics;
+}
+
+Canvas& Canvas::setFrameStatisticsWindow(const std::size_t frames) {
+  m_statistics.setWindowSize(frames);
+  return *this;
+}
 
 // Helper functions
 
@@ -0,0 +1,58 @@
+#include "dana/damage_region.h"
+
+#include <algorithm>
+
+namespace dana {
+
+void DamageRegion::add(const Rect& rect) noexcept {
+  if (rect.width <= 0 || rect.height <= 0) {
+    return;
+  }
+  if (m_empty) {
+    m_bounds = rect;
+    m_empty = false;
+    return;
+  }
+  const auto right{std::max(m_bounds.x + m_bounds.width, rect.x + rect.width)};
+  const auto bottom{
+      std::max(m_bounds.y + m_bounds.height, rect.y + rect.height)};
+
+  m_bounds.x = std::min(m_bounds.x, rect.x);
+  m_bounds.y = std::min(m_bounds.y, rect.y);
+  m_bounds.width = right - m_bounds.x;
+  m_bounds.height = bottom - m_bounds.y;
+}
+
+void DamageRegion::addAll() noexcept {
+  m_full = true;
+  m_empty = false;
+}
+
+bool DamageRegion::isEmpty() const noexcept { return m_empty; }
+
+bool DamageRegion::isFull() const noexcept { return m_full; }
+
+Rect DamageRegion::getBounds(const Rect& area) const noexcept {
+  if (m_full) {
+    return area;
+  }
+  if (m_empty) {
+    return {area.x, area.y, 0, 0};
+  }
+  const auto left{std::max(m_bounds.x, area.x)};
+  const auto top{std::max(m_bounds.y, area.y)};
+  const auto right{
+      std::min(m_bounds.x + m_bounds.width, area.x + area.width)};
+  const auto bottom{
+      std::min(m_bounds.y + m_bounds.height, area.y + area.height)};
+
+  return {left, top, std::max(right - left, 0.0f),
+          std::max(bottom - top, 0.0f)};
+}
+
+void DamageRegion::clear() noexcept {
+  m_bounds = {};
+  m_empty = true;
+  m_full = false;
+}
+}  // namespace dana
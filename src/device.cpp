@@ -0,0 +1,442 @@
+#include "dana/device.h"
+#include "dana/canvas.h"
+
+#include <GL/glew.h>
+#include <SDL.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace dana {
+
+// Frame rate used for pacing when swaps cannot be synchronized with the display
+static constexpr double fallback_frame_rate{60.0};
+
+// Number of events that can be pending for the render thread
+static constexpr std::size_t event_queue_capacity{1024};
+
+static int getSwapIntervalValue(const SwapIntervals swap_interval) noexcept {
+  switch (swap_interval) {
+    case SwapIntervals::ADAPTIVE_VSYNC:
+      return -1;
+    case SwapIntervals::VSYNC:
+      return 1;
+    case SwapIntervals::IMMEDIATE:
+      return 0;
+  }
+  return 0;
+}
+
+// Returns the ID of the window an event belongs to, or zero if it is not tied
+// to a window
+static uint32_t getWindowId(const SDL_Event& event) noexcept {
+  switch (event.type) {
+    case SDL_WINDOWEVENT:
+      return event.window.windowID;
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+      return event.key.windowID;
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+      return event.button.windowID;
+    case SDL_MOUSEMOTION:
+      return event.motion.windowID;
+    case SDL_MOUSEWHEEL:
+      return event.wheel.windowID;
+  }
+  return 0;
+}
+
+Device::Device() {
+  constexpr const Uint32 sdl_flags{SDL_INIT_VIDEO};
+
+  SDL_Init(sdl_flags);
+
+  createContext();
+}
+
+Device::Device(HeadlessMode) {
+  constexpr const Uint32 sdl_flags{SDL_INIT_EVENTS};
+
+  SDL_Init(sdl_flags);
+
+  // Prefer the offscreen video driver, which does not need a display server
+  if (SDL_VideoInit("offscreen") != 0 && SDL_VideoInit(nullptr) != 0) {
+    throw std::runtime_error("Unable to initialize SDL video");
+  }
+  createContext();
+  setUncapped();
+}
+
+Device::~Device() noexcept {
+  // GL resources have to be released while the context is still alive. The
+  // loader goes first, so images that have not started decoding are skipped
+  makeCurrent(nullptr);
+  m_image_loader.reset();
+  m_thread_pool.reset();
+  m_framebuffer_pool.clear();
+  m_pencil.reset();
+  m_gl_context.reset();
+  m_window.reset();
+  SDL_Quit();
+}
+
+void Device::createContext() {
+  // NOTE: For now only hard code GL-version to 3.1
+  SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+
+  SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 8);
+  SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 8);
+  SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 8);
+  SDL_GL_SetAttribute(SDL_GL_ALPHA_SIZE, 8);
+  SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, 8);
+  SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
+  SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+  // The context is created on a hidden window of its own, so it outlives the
+  // windows of the canvases and is usable before any canvas is created
+  m_window = c_unique_ptr<SDL_Window>(
+      SDL_CreateWindow("", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 1,
+                       1, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN),
+      [](auto* ptr) { SDL_DestroyWindow(ptr); });
+
+  if (nullptr == m_window) {
+    throw std::runtime_error("Unable to initialize SDL window");
+  }
+  m_gl_context =
+      c_unique_ptr<void>(SDL_GL_CreateContext(m_window.get()),
+                         [](auto* ptr) { SDL_GL_DeleteContext(ptr); });
+
+  if (nullptr == m_gl_context) {
+    throw std::runtime_error("Unable to create OpenGL context");
+  }
+  glewExperimental = GL_TRUE;
+
+  const auto glew_status{glewInit()};
+
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+  // GLEW built for GLX reports this for EGL contexts, which are still usable
+  if (glew_status != GLEW_OK && glew_status != GLEW_ERROR_NO_GLX_DISPLAY) {
+#else
+  if (glew_status != GLEW_OK) {
+#endif
+    throw std::runtime_error("Unable to initialize Glew");
+  }
+
+  m_pencil = std::make_unique<Pencil>();
+  m_invalidate_event = SDL_RegisterEvents(1);
+  m_events = std::make_unique<SpscQueue<SDL_Event>>(event_queue_capacity);
+
+  setSwapInterval(SwapIntervals::VSYNC);
+
+  if (m_swap_interval == SwapIntervals::IMMEDIATE) {
+    m_scheduler.setTargetFrameRate(fallback_frame_rate);
+  }
+}
+
+Pencil& Device::getPencil() noexcept { return *m_pencil; }
+
+FramebufferPool& Device::getFramebufferPool() noexcept {
+  return m_framebuffer_pool;
+}
+
+ThreadPool& Device::getThreadPool() {
+  if (!m_thread_pool) {
+    m_thread_pool = std::make_unique<ThreadPool>();
+  }
+  return *m_thread_pool;
+}
+
+ImageLoader& Device::getImageLoader() {
+  if (!m_image_loader) {
+    m_image_loader = std::make_unique<ImageLoader>(
+        getPencil(), getThreadPool(), [this] { wakeUp(); });
+  }
+  return *m_image_loader;
+}
+
+Device& Device::setTargetFrameRate(const double frame_rate) noexcept {
+  m_scheduler.setTargetFrameRate(frame_rate);
+  return *this;
+}
+
+Device& Device::setSwapInterval(const SwapIntervals swap_interval) noexcept {
+  m_swap_interval = swap_interval;
+
+  if (m_swap_interval == SwapIntervals::ADAPTIVE_VSYNC &&
+      SDL_GL_SetSwapInterval(-1) != 0) {
+    m_swap_interval = SwapIntervals::VSYNC;
+  }
+  if (m_swap_interval == SwapIntervals::VSYNC &&
+      SDL_GL_SetSwapInterval(1) != 0) {
+    m_swap_interval = SwapIntervals::IMMEDIATE;
+  }
+  if (m_swap_interval == SwapIntervals::IMMEDIATE) {
+    SDL_GL_SetSwapInterval(0);
+  }
+  // Make the next swap apply the interval to the window it swaps
+  m_swap_window = nullptr;
+  return *this;
+}
+
+SwapIntervals Device::getSwapInterval() const noexcept {
+  return m_swap_interval;
+}
+
+Device& Device::setUncapped() noexcept {
+  m_scheduler.setTargetFrameRate(0.0);
+  return setSwapInterval(SwapIntervals::IMMEDIATE);
+}
+
+Device& Device::setThreadedRendering(const bool enabled) noexcept {
+  m_threaded_rendering = enabled;
+  return *this;
+}
+
+bool Device::isThreadedRendering() const noexcept {
+  return m_threaded_rendering;
+}
+
+void Device::run() noexcept {
+  for (auto* canvas : m_canvases) {
+    if (!canvas->isHeadless() && canvas->m_show) {
+      SDL_ShowWindow(canvas->m_window.get());
+    }
+  }
+  if (!m_threaded_rendering) {
+    render();
+    return;
+  }
+  // A context can only be current on one thread at a time
+  SDL_GL_MakeCurrent(m_window.get(), nullptr);
+  m_render_thread_running = true;
+
+  std::thread render_thread([this] {
+    makeCurrent(nullptr);
+    render();
+    SDL_GL_MakeCurrent(m_window.get(), nullptr);
+    m_render_thread_running = false;
+
+    // Wake up the main thread, which is blocked waiting for events
+    wakeUp();
+  });
+
+  SDL_Event event;
+
+  while (m_render_thread_running) {
+    if (SDL_WaitEvent(&event) != 0) {
+      receiveEvent(event);
+    }
+  }
+  render_thread.join();
+  makeCurrent(nullptr);
+
+  // Events the render thread did not get to are of no use anymore
+  while (m_events->tryPop(event)) {
+  }
+}
+
+void Device::pollEvents() noexcept {
+  SDL_Event event;
+
+  while (SDL_PollEvent(&event)) {
+    receiveEvent(event);
+  }
+}
+
+void Device::addCanvas(Canvas* canvas) { m_canvases.push_back(canvas); }
+
+void Device::removeCanvas(Canvas* canvas) noexcept {
+  m_canvases.erase(std::remove(m_canvases.begin(), m_canvases.end(), canvas),
+                   m_canvases.end());
+
+  if (!canvas->isHeadless() && canvas->m_window.get() == m_swap_window) {
+    m_swap_window = nullptr;
+  }
+}
+
+void Device::makeCurrent(SDL_Window* window) noexcept {
+  SDL_GL_MakeCurrent(nullptr != window ? window : m_window.get(),
+                     m_gl_context.get());
+}
+
+void Device::swapWindow(SDL_Window* window, const bool synchronize) noexcept {
+  const int swap_interval{
+      synchronize ? getSwapIntervalValue(m_swap_interval) : 0};
+
+  // Depending on the platform the interval belongs to either the context or
+  // the window, so it is applied again whenever the swapped window changes
+  if (window != m_swap_window || swap_interval != m_applied_swap_interval) {
+    SDL_GL_SetSwapInterval(swap_interval);
+    m_swap_window = window;
+    m_applied_swap_interval = swap_interval;
+  }
+  SDL_GL_SwapWindow(window);
+}
+
+void Device::wakeUp() noexcept {
+  SDL_Event event{};
+  event.type = m_invalidate_event;
+  SDL_PushEvent(&event);
+}
+
+void Device::render() noexcept {
+  std::vector<Canvas*> due_canvases;
+
+  m_scheduler.reset();
+
+  while (isRunning()) {
+    // Draw again until all decoded images have been uploaded
+    if (m_image_loader && m_image_loader->hasPendingUploads()) {
+      requestUploadFrame();
+    }
+    waitForEvents();
+
+    const auto begin_time{std::chrono::steady_clock::now()};
+
+    handleEvents();
+    due_canvases.clear();
+
+    for (auto* canvas : m_canvases) {
+      if (!canvas->isHeadless() && canvas->m_show &&
+          canvas->isFrameDue(begin_time)) {
+        due_canvases.push_back(canvas);
+      }
+    }
+    if (due_canvases.empty()) {
+      continue;
+    }
+    auto frame_begin_time{begin_time};
+
+    for (std::size_t i = 0; i < due_canvases.size(); ++i) {
+      due_canvases[i]->drawFrame(frame_begin_time,
+                                 i + 1 == due_canvases.size());
+      frame_begin_time = std::chrono::steady_clock::now();
+    }
+    m_scheduler.waitForNextFrame();
+  }
+  for (auto* canvas : m_canvases) {
+    canvas->flushReadbacks();
+  }
+}
+
+bool Device::isRunning() const noexcept {
+  for (const auto* canvas : m_canvases) {
+    if (!canvas->isHeadless() && canvas->m_show) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Device::requestUploadFrame() noexcept {
+  // Images are uploaded in frames of any canvas, so a frame of the first
+  // visible one is requested. Nothing is damaged, the images damage canvases
+  // like any other drawing once they are drawn.
+  for (auto* canvas : m_canvases) {
+    if (!canvas->isHeadless() && canvas->m_show &&
+        canvas->m_redraw.isVisible()) {
+      canvas->m_redraw.requestFrame();
+      return;
+    }
+  }
+}
+
+int Device::getEventTimeout() const noexcept {
+  const auto now{std::chrono::steady_clock::now()};
+  int timeout{-1};
+
+  for (const auto* canvas : m_canvases) {
+    if (canvas->isHeadless() || !canvas->m_show) {
+      continue;
+    }
+    const auto canvas_timeout{canvas->getEventTimeout(now)};
+
+    if (canvas_timeout == 0) {
+      return 0;
+    }
+    if (canvas_timeout > 0 && (timeout < 0 || canvas_timeout < timeout)) {
+      timeout = canvas_timeout;
+    }
+  }
+  return timeout;
+}
+
+void Device::waitForEvents() noexcept {
+  const auto timeout{getEventTimeout()};
+
+  if (timeout == 0) {
+    return;
+  }
+  if (m_render_thread_running) {
+    const auto has_events = [this] { return !m_events->isEmpty(); };
+    std::unique_lock<std::mutex> lock(m_events_mutex);
+
+    if (timeout < 0) {
+      m_events_received.wait(lock, has_events);
+    } else {
+      m_events_received.wait_for(lock, std::chrono::milliseconds(timeout),
+                                 has_events);
+    }
+    return;
+  }
+  SDL_Event event;
+
+  if (SDL_WaitEventTimeout(&event, timeout) != 0) {
+    receiveEvent(event);
+  }
+}
+
+void Device::handleEvents() noexcept {
+  if (!m_render_thread_running) {
+    pollEvents();
+    return;
+  }
+  SDL_Event event;
+
+  while (m_events->tryPop(event)) {
+    dispatchEvent(event);
+  }
+}
+
+void Device::receiveEvent(const SDL_Event& event) noexcept {
+  // Windows are hidden by the thread that pumps events, as SDL requires
+  if (event.type == SDL_WINDOWEVENT &&
+      event.window.event == SDL_WINDOWEVENT_CLOSE) {
+    SDL_HideWindow(SDL_GetWindowFromID(event.window.windowID));
+  }
+  if (!m_render_thread_running) {
+    dispatchEvent(event);
+    return;
+  }
+  while (!m_events->tryPush(event)) {
+    if (!m_render_thread_running) {
+      return;
+    }
+    std::this_thread::yield();
+  }
+  {
+    // Locking makes sure the render thread is either waiting or will see the
+    // event before it starts waiting
+    std::lock_guard<std::mutex> lock(m_events_mutex);
+  }
+  m_events_received.notify_one();
+}
+
+void Device::dispatchEvent(const SDL_Event& event) noexcept {
+  // Invalidation events only serve to wake up the event loop
+  if (event.type == m_invalidate_event) {
+    return;
+  }
+  const auto window_id{getWindowId(event)};
+
+  for (auto* canvas : m_canvases) {
+    if (window_id == 0 || window_id == canvas->m_window_id) {
+      canvas->handleEvent(event);
+    }
+  }
+}
+}  // namespace dana
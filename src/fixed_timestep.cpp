@@ -0,0 +1,64 @@
+#include "dana/fixed_timestep.h"
+
+namespace dana {
+
+FixedTimestep::FixedTimestep(const double update_rate) noexcept {
+  setUpdateRate(update_rate);
+}
+
+void FixedTimestep::setUpdateRate(const double update_rate) noexcept {
+  if (update_rate <= 0.0) {
+    return;
+  }
+  m_step = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(1.0 / update_rate));
+  m_accumulator = Clock::duration::zero();
+}
+
+double FixedTimestep::getUpdateRate() const noexcept {
+  return 1.0 / std::chrono::duration<double>(m_step).count();
+}
+
+float FixedTimestep::getStepSeconds() const noexcept {
+  return std::chrono::duration<float>(m_step).count();
+}
+
+void FixedTimestep::setMaxSteps(const std::size_t max_steps) noexcept {
+  m_max_steps = max_steps;
+}
+
+std::size_t FixedTimestep::getMaxSteps() const noexcept { return m_max_steps; }
+
+std::size_t FixedTimestep::advance(const Clock::time_point now) noexcept {
+  if (!m_started) {
+    m_started = true;
+    m_last_time = now;
+    return 0;
+  }
+  m_accumulator += now - m_last_time;
+  m_last_time = now;
+
+  auto steps{static_cast<std::size_t>(m_accumulator / m_step)};
+  m_accumulator -= m_step * static_cast<Clock::rep>(steps);
+
+  if (steps > m_max_steps) {
+    m_skipped_steps += steps - m_max_steps;
+    steps = m_max_steps;
+  }
+  return steps;
+}
+
+float FixedTimestep::getAlpha() const noexcept {
+  return std::chrono::duration<float>(m_accumulator) /
+         std::chrono::duration<float>(m_step);
+}
+
+uint64_t FixedTimestep::getSkippedSteps() const noexcept {
+  return m_skipped_steps;
+}
+
+void FixedTimestep::reset() noexcept {
+  m_accumulator = Clock::duration::zero();
+  m_started = false;
+}
+}  // namespace dana
@@ -0,0 +1,338 @@
+#include "dana/frame_exporter.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace dana {
+
+static constexpr std::size_t bytes_per_pixel{4};
+
+// Frames are stored bottom to top, as read from OpenGL
+static const unsigned char* getRow(const std::vector<unsigned char>& pixels,
+                                   const int width, const int height,
+                                   const int top_down_row) noexcept {
+  const auto row{static_cast<std::size_t>(height - 1 - top_down_row)};
+  const auto row_size{static_cast<std::size_t>(width) * bytes_per_pixel};
+  return pixels.data() + row * row_size;
+}
+
+static uint32_t crc32(uint32_t crc, const unsigned char* data,
+                      const std::size_t size) noexcept {
+  static const auto table{[] {
+    std::array<uint32_t, 256> values{};
+    for (uint32_t i = 0; i < values.size(); ++i) {
+      uint32_t value{i};
+      for (int bit = 0; bit < 8; ++bit) {
+        value = (value & 1u) ? 0xEDB88320u ^ (value >> 1u) : value >> 1u;
+      }
+      values[i] = value;
+    }
+    return values;
+  }()};
+
+  crc = ~crc;
+  for (std::size_t i = 0; i < size; ++i) {
+    crc = table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8u);
+  }
+  return ~crc;
+}
+
+static uint32_t adler32(const unsigned char* data, std::size_t size) noexcept {
+  // Largest number of bytes that can be summed before the sums overflow
+  constexpr std::size_t chunk_size{5552};
+  constexpr uint32_t modulus{65521};
+
+  uint32_t a{1};
+  uint32_t b{0};
+
+  while (size > 0) {
+    const auto chunk{std::min(size, chunk_size)};
+    for (std::size_t i = 0; i < chunk; ++i) {
+      a += data[i];
+      b += a;
+    }
+    a %= modulus;
+    b %= modulus;
+    data += chunk;
+    size -= chunk;
+  }
+  return (b << 16u) | a;
+}
+
+static void appendU32(std::vector<unsigned char>& bytes,
+                      const uint32_t value) noexcept {
+  bytes.push_back(static_cast<unsigned char>(value >> 24u));
+  bytes.push_back(static_cast<unsigned char>(value >> 16u));
+  bytes.push_back(static_cast<unsigned char>(value >> 8u));
+  bytes.push_back(static_cast<unsigned char>(value));
+}
+
+static void writeChunk(std::ostream& out, const char* type,
+                       const std::vector<unsigned char>& data) {
+  std::vector<unsigned char> chunk;
+  chunk.reserve(data.size() + 12);
+  appendU32(chunk, static_cast<uint32_t>(data.size()));
+  chunk.insert(chunk.end(), type, type + 4);
+  chunk.insert(chunk.end(), data.begin(), data.end());
+  appendU32(chunk, crc32(0, chunk.data() + 4, chunk.size() - 4));
+  out.write(reinterpret_cast<const char*>(chunk.data()),
+            static_cast<std::streamsize>(chunk.size()));
+}
+
+// Writes an RGBA PNG whose image data is stored in uncompressed deflate
+// blocks. That keeps encoding cheap and needs no compression library.
+static bool writePng(const std::string& filename, const int width,
+                     const int height,
+                     const std::vector<unsigned char>& pixels) {
+  constexpr std::size_t max_block_size{65535};
+  constexpr std::array<unsigned char, 8> signature{0x89, 'P', 'N', 'G',
+                                                   '\r', '\n', 0x1A, '\n'};
+
+  const auto row_size{static_cast<std::size_t>(width) * bytes_per_pixel};
+
+  std::vector<unsigned char> filtered;
+  filtered.reserve((row_size + 1) * static_cast<std::size_t>(height));
+
+  for (int row = 0; row < height; ++row) {
+    const auto* data{getRow(pixels, width, height, row)};
+    filtered.push_back(0);
+    filtered.insert(filtered.end(), data, data + row_size);
+  }
+
+  std::vector<unsigned char> compressed;
+  compressed.reserve(filtered.size() + filtered.size() / max_block_size * 5 +
+                     11);
+  compressed.push_back(0x78);
+  compressed.push_back(0x01);
+
+  std::size_t offset{0};
+  do {
+    const auto block_size{std::min(filtered.size() - offset, max_block_size)};
+    const bool final_block{offset + block_size == filtered.size()};
+    compressed.push_back(final_block ? 1 : 0);
+    compressed.push_back(static_cast<unsigned char>(block_size));
+    compressed.push_back(static_cast<unsigned char>(block_size >> 8u));
+    compressed.push_back(static_cast<unsigned char>(~block_size));
+    compressed.push_back(static_cast<unsigned char>(~block_size >> 8u));
+    compressed.insert(compressed.end(), filtered.begin() + offset,
+                      filtered.begin() + offset + block_size);
+    offset += block_size;
+  } while (offset < filtered.size());
+
+  appendU32(compressed, adler32(filtered.data(), filtered.size()));
+
+  std::vector<unsigned char> header;
+  appendU32(header, static_cast<uint32_t>(width));
+  appendU32(header, static_cast<uint32_t>(height));
+  header.insert(header.end(), {8, 6, 0, 0, 0});
+
+  std::ofstream out(filename, std::ios::binary);
+  out.write(reinterpret_cast<const char*>(signature.data()), signature.size());
+  writeChunk(out, "IHDR", header);
+  writeChunk(out, "IDAT", compressed);
+  writeChunk(out, "IEND", {});
+  return out.good();
+}
+
+static bool writeRaw(std::ostream& out, const int width, const int height,
+                     const std::vector<unsigned char>& pixels) {
+  const auto row_size{static_cast<std::streamsize>(width * bytes_per_pixel)};
+
+  for (int row = 0; row < height; ++row) {
+    out.write(reinterpret_cast<const char*>(getRow(pixels, width, height, row)),
+              row_size);
+  }
+  return out.good();
+}
+
+// Converts to full resolution BT.601 YCbCr, which ffmpeg reads as yuv444p
+static bool writeY4m(std::ostream& out, const int width, const int height,
+                     const std::vector<unsigned char>& pixels) {
+  const auto plane_size{static_cast<std::size_t>(width) *
+                        static_cast<std::size_t>(height)};
+  std::vector<unsigned char> planes(plane_size * 3);
+
+  auto* y_plane{planes.data()};
+  auto* u_plane{y_plane + plane_size};
+  auto* v_plane{u_plane + plane_size};
+
+  for (int row = 0; row < height; ++row) {
+    const auto* data{getRow(pixels, width, height, row)};
+
+    for (int column = 0; column < width; ++column) {
+      const int r{data[0]};
+      const int g{data[1]};
+      const int b{data[2]};
+      *y_plane++ = static_cast<unsigned char>(
+          ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+      *u_plane++ = static_cast<unsigned char>(
+          ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+      *v_plane++ = static_cast<unsigned char>(
+          ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+      data += bytes_per_pixel;
+    }
+  }
+  out << "FRAME\n";
+  out.write(reinterpret_cast<const char*>(planes.data()),
+            static_cast<std::streamsize>(planes.size()));
+  return out.good();
+}
+
+FrameExporter::FrameExporter(const std::string& path,
+                             const FrameFormats format,
+                             const QueuePolicies policy,
+                             const std::size_t queue_capacity)
+    : m_path{path},
+      m_format{format},
+      m_policy{policy},
+      m_capacity{std::max<std::size_t>(queue_capacity, 1)} {
+  std::size_t worker_count{1};
+
+  if (m_format == FrameFormats::PNG) {
+    // Frames go to separate files, so they can be encoded in any order
+    worker_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+  } else {
+    m_stream.open(m_path, std::ios::binary | std::ios::trunc);
+
+    if (!m_stream) {
+      throw std::runtime_error("Unable to open " + m_path);
+    }
+  }
+  for (std::size_t i = 0; i < worker_count; ++i) {
+    m_workers.emplace_back([this] { work(); });
+  }
+}
+
+FrameExporter::~FrameExporter() noexcept {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_queue_filled.notify_all();
+
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+FrameExporter& FrameExporter::setFrameRate(const int frame_rate) noexcept {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_frame_rate = frame_rate;
+  return *this;
+}
+
+void FrameExporter::submit(const FramePixels& pixels) noexcept {
+  std::vector<unsigned char> buffer;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (m_queue.size() >= m_capacity) {
+      if (m_policy == QueuePolicies::DROP) {
+        ++m_dropped_frames;
+        return;
+      }
+      m_queue_drained.wait(lock,
+                           [this] { return m_queue.size() < m_capacity; });
+    }
+    if (!m_buffers.empty()) {
+      buffer = std::move(m_buffers.back());
+      m_buffers.pop_back();
+    }
+  }
+  const auto row_size{static_cast<std::size_t>(pixels.width) *
+                      bytes_per_pixel};
+  buffer.resize(row_size * static_cast<std::size_t>(pixels.height));
+
+  for (int row = 0; row < pixels.height; ++row) {
+    std::memcpy(buffer.data() + row * row_size,
+                pixels.data + static_cast<std::ptrdiff_t>(row) * pixels.stride,
+                row_size);
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.push_back(
+        Frame{pixels.frame, pixels.width, pixels.height, std::move(buffer)});
+  }
+  m_queue_filled.notify_one();
+}
+
+void FrameExporter::wait() noexcept {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_queue_drained.wait(
+      lock, [this] { return m_queue.empty() && m_busy_workers == 0; });
+}
+
+uint64_t FrameExporter::getEncodedFrames() const noexcept {
+  return m_encoded_frames;
+}
+
+uint64_t FrameExporter::getDroppedFrames() const noexcept {
+  return m_dropped_frames;
+}
+
+void FrameExporter::work() noexcept {
+  while (true) {
+    Frame frame;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_queue_filled.wait(lock,
+                          [this] { return m_stopping || !m_queue.empty(); });
+
+      if (m_queue.empty()) {
+        return;
+      }
+      frame = std::move(m_queue.front());
+      m_queue.pop_front();
+      ++m_busy_workers;
+    }
+    m_queue_drained.notify_all();
+
+    if (encode(frame)) {
+      ++m_encoded_frames;
+    } else {
+      ++m_dropped_frames;
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_buffers.push_back(std::move(frame.pixels));
+      --m_busy_workers;
+    }
+    m_queue_drained.notify_all();
+  }
+}
+
+bool FrameExporter::encode(const Frame& frame) noexcept {
+  try {
+    if (m_format == FrameFormats::PNG) {
+      std::ostringstream filename;
+      filename << m_path << std::setw(6) << std::setfill('0') << frame.index
+               << ".png";
+      return writePng(filename.str(), frame.width, frame.height, frame.pixels);
+    }
+    // Stream formats are written by a single worker, so frames stay in order
+    if (m_stream_width == 0) {
+      m_stream_width = frame.width;
+      m_stream_height = frame.height;
+
+      if (m_format == FrameFormats::Y4M) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stream << "YUV4MPEG2 W" << frame.width << " H" << frame.height
+                 << " F" << m_frame_rate << ":1 Ip A1:1 C444\n";
+      }
+    }
+    if (frame.width != m_stream_width || frame.height != m_stream_height) {
+      return false;
+    }
+    if (m_format == FrameFormats::Y4M) {
+      return writeY4m(m_stream, frame.width, frame.height, frame.pixels);
+    }
+    return writeRaw(m_stream, frame.width, frame.height, frame.pixels);
+  } catch (const std::exception&) {
+    return false;
+  }
+}
+}  // namespace dana
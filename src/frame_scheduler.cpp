@@ -0,0 +1,63 @@
+#include "dana/frame_scheduler.h"
+
+#include <thread>
+
+namespace dana {
+
+// Sleeping is only accurate to the granularity of the OS scheduler, so the last
+// part of the wait is spent yielding instead.
+static constexpr std::chrono::microseconds spin_threshold{1000};
+
+static void sleepUntil(
+    const FrameScheduler::Clock::time_point deadline) noexcept {
+  if (deadline - FrameScheduler::Clock::now() > spin_threshold) {
+    std::this_thread::sleep_until(deadline - spin_threshold);
+  }
+  while (FrameScheduler::Clock::now() < deadline) {
+    std::this_thread::yield();
+  }
+}
+
+void FrameScheduler::setTargetFrameRate(const double frame_rate) noexcept {
+  if (frame_rate <= 0.0) {
+    m_frame_period = Clock::duration::zero();
+  } else {
+    m_frame_period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / frame_rate));
+  }
+  reset();
+}
+
+double FrameScheduler::getTargetFrameRate() const noexcept {
+  if (isUncapped()) {
+    return 0.0;
+  }
+  return 1.0 / std::chrono::duration<double>(m_frame_period).count();
+}
+
+bool FrameScheduler::isUncapped() const noexcept {
+  return m_frame_period == Clock::duration::zero();
+}
+
+void FrameScheduler::reset() noexcept {
+  m_deadline = Clock::now() + m_frame_period;
+}
+
+FrameScheduler::Clock::time_point FrameScheduler::getDeadline() const noexcept {
+  return m_deadline;
+}
+
+void FrameScheduler::waitForNextFrame() noexcept {
+  if (isUncapped()) {
+    return;
+  }
+  const auto now{Clock::now()};
+
+  if (now < m_deadline) {
+    sleepUntil(m_deadline);
+  } else if (now - m_deadline > m_frame_period) {
+    m_deadline = now;
+  }
+  m_deadline += m_frame_period;
+}
+}  // namespace dana
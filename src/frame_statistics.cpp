@@ -0,0 +1,93 @@
+#include "dana/frame_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace dana {
+
+static constexpr std::size_t index(const FramePhases phase) noexcept {
+  return static_cast<std::size_t>(phase);
+}
+
+// Nearest-rank percentile of an ascending range
+static std::chrono::nanoseconds percentile(
+    const std::vector<std::chrono::nanoseconds>& sorted,
+    const double fraction) noexcept {
+  const auto rank{static_cast<std::size_t>(
+      std::ceil(fraction * static_cast<double>(sorted.size())))};
+  return sorted[std::max<std::size_t>(rank, 1) - 1];
+}
+
+FrameStatistics::FrameStatistics(const std::size_t window_size) {
+  setWindowSize(window_size);
+}
+
+void FrameStatistics::setWindowSize(const std::size_t window_size) {
+  m_window_size = std::max<std::size_t>(window_size, 1);
+
+  for (auto& samples : m_samples) {
+    samples.values = {};
+    samples.values.reserve(m_window_size);
+    samples.next = 0;
+  }
+  m_sorted.reserve(m_window_size);
+}
+
+std::size_t FrameStatistics::getWindowSize() const noexcept {
+  return m_window_size;
+}
+
+void FrameStatistics::record(const FramePhases phase,
+                             const std::chrono::nanoseconds duration) noexcept {
+  auto& samples{m_samples[index(phase)]};
+
+  if (samples.values.size() < m_window_size) {
+    samples.values.push_back(duration);
+  } else {
+    samples.values[samples.next] = duration;
+  }
+  samples.next = (samples.next + 1) % m_window_size;
+}
+
+std::chrono::nanoseconds FrameStatistics::getLast(
+    const FramePhases phase) const noexcept {
+  const auto& samples{m_samples[index(phase)]};
+
+  if (samples.values.empty()) {
+    return std::chrono::nanoseconds{0};
+  }
+  return samples.values[(samples.next + m_window_size - 1) % m_window_size];
+}
+
+FrameTimeSummary FrameStatistics::getSummary(
+    const FramePhases phase) const noexcept {
+  const auto& samples{m_samples[index(phase)]};
+  FrameTimeSummary summary;
+
+  if (samples.values.empty()) {
+    return summary;
+  }
+  m_sorted.assign(samples.values.begin(), samples.values.end());
+  std::sort(m_sorted.begin(), m_sorted.end());
+
+  const auto sum{std::accumulate(m_sorted.begin(), m_sorted.end(),
+                                 std::chrono::nanoseconds{0})};
+
+  summary.samples = m_sorted.size();
+  summary.min = m_sorted.front();
+  summary.max = m_sorted.back();
+  summary.mean = sum / static_cast<long long>(summary.samples);
+  summary.p50 = percentile(m_sorted, 0.50);
+  summary.p95 = percentile(m_sorted, 0.95);
+  summary.p99 = percentile(m_sorted, 0.99);
+  return summary;
+}
+
+void FrameStatistics::clear() noexcept {
+  for (auto& samples : m_samples) {
+    samples.values.clear();
+    samples.next = 0;
+  }
+}
+}  // namespace dana
@@ -0,0 +1,109 @@
+#include "dana/framebuffer.h"
+
+#include <GL/glew.h>
+
+#include <stdexcept>
+
+namespace dana {
+
+Framebuffer::Framebuffer(const int width, const int height)
+    : m_width{width}, m_height{height} {
+  GLint previous_framebuffer{0};
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous_framebuffer);
+
+  glGenTextures(1, &m_texture);
+  glBindTexture(GL_TEXTURE_2D, m_texture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA,
+               GL_UNSIGNED_BYTE, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  glGenRenderbuffers(1, &m_renderbuffer);
+  glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffer);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  glGenFramebuffers(1, &m_framebuffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                         m_texture, 0);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+                            GL_RENDERBUFFER, m_renderbuffer);
+
+  const auto status{glCheckFramebufferStatus(GL_FRAMEBUFFER)};
+  glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previous_framebuffer));
+
+  if (status != GL_FRAMEBUFFER_COMPLETE) {
+    release();
+    throw std::runtime_error("Unable to create framebuffer");
+  }
+}
+
+Framebuffer::Framebuffer(Framebuffer&& framebuffer) noexcept
+    : m_framebuffer{framebuffer.m_framebuffer},
+      m_texture{framebuffer.m_texture},
+      m_renderbuffer{framebuffer.m_renderbuffer},
+      m_width{framebuffer.m_width},
+      m_height{framebuffer.m_height} {
+  framebuffer.m_framebuffer = 0;
+  framebuffer.m_texture = 0;
+  framebuffer.m_renderbuffer = 0;
+}
+
+Framebuffer::~Framebuffer() noexcept { release(); }
+
+Framebuffer& Framebuffer::operator=(Framebuffer&& framebuffer) noexcept {
+  if (this != &framebuffer) {
+    release();
+    m_framebuffer = framebuffer.m_framebuffer;
+    m_texture = framebuffer.m_texture;
+    m_renderbuffer = framebuffer.m_renderbuffer;
+    m_width = framebuffer.m_width;
+    m_height = framebuffer.m_height;
+    framebuffer.m_framebuffer = 0;
+    framebuffer.m_texture = 0;
+    framebuffer.m_renderbuffer = 0;
+  }
+  return *this;
+}
+
+void Framebuffer::bind() const noexcept {
+  glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+}
+
+void Framebuffer::unbind() noexcept { glBindFramebuffer(GL_FRAMEBUFFER, 0); }
+
+void Framebuffer::blitToWindow() const noexcept {
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+  glBlitFramebuffer(0, 0, m_width, m_height, 0, 0, m_width, m_height,
+                    GL_COLOR_BUFFER_BIT, GL_NEAREST);
+  unbind();
+}
+
+unsigned int Framebuffer::getHandle() const noexcept { return m_framebuffer; }
+
+unsigned int Framebuffer::getTexture() const noexcept { return m_texture; }
+
+std::pair<int, int> Framebuffer::getSize() const noexcept {
+  return {m_width, m_height};
+}
+
+void Framebuffer::release() noexcept {
+  if (m_framebuffer != 0) {
+    glDeleteFramebuffers(1, &m_framebuffer);
+    m_framebuffer = 0;
+  }
+  if (m_renderbuffer != 0) {
+    glDeleteRenderbuffers(1, &m_renderbuffer);
+    m_renderbuffer = 0;
+  }
+  if (m_texture != 0) {
+    glDeleteTextures(1, &m_texture);
+    m_texture = 0;
+  }
+}
+}  // namespace dana
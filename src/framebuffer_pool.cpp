@@ -0,0 +1,55 @@
+#include "dana/framebuffer_pool.h"
+
+#include <utility>
+
+namespace dana {
+
+std::unique_ptr<Framebuffer> FramebufferPool::acquire(const int width,
+                                                      const int height) {
+  const auto size{std::make_pair(width, height)};
+
+  // Search from the back, which holds the most recently released framebuffers
+  for (auto it = m_framebuffers.rbegin(); it != m_framebuffers.rend(); ++it) {
+    if ((*it)->getSize() == size) {
+      auto framebuffer{std::move(*it)};
+      m_framebuffers.erase(std::next(it).base());
+      ++m_reused;
+      return framebuffer;
+    }
+  }
+  ++m_created;
+  return std::make_unique<Framebuffer>(width, height);
+}
+
+void FramebufferPool::release(
+    std::unique_ptr<Framebuffer> framebuffer) noexcept {
+  if (nullptr == framebuffer || m_capacity == 0) {
+    return;
+  }
+  if (m_framebuffers.size() >= m_capacity) {
+    m_framebuffers.erase(m_framebuffers.begin());
+  }
+  m_framebuffers.push_back(std::move(framebuffer));
+}
+
+void FramebufferPool::setCapacity(const std::size_t capacity) noexcept {
+  m_capacity = capacity;
+
+  if (m_framebuffers.size() > m_capacity) {
+    m_framebuffers.erase(m_framebuffers.begin(),
+                         m_framebuffers.end() - m_capacity);
+  }
+}
+
+std::size_t FramebufferPool::getSize() const noexcept {
+  return m_framebuffers.size();
+}
+
+uint64_t FramebufferPool::getCreatedCount() const noexcept {
+  return m_created;
+}
+
+uint64_t FramebufferPool::getReusedCount() const noexcept { return m_reused; }
+
+void FramebufferPool::clear() noexcept { m_framebuffers.clear(); }
+}  // namespace dana
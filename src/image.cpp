@@ -11,23 +11,44 @@ Image::Image(const std::shared_ptr<NVGcontext>& context,
              ImageHandle handle) noexcept
     : m_context{context}, m_handle{handle} {}
 
+Image::Image(const std::shared_ptr<NVGcontext>& context,
+             const ImageHandle handle, const Rect& region,
+             std::shared_ptr<void> texture_owner) noexcept
+    : m_context{context},
+      m_handle{handle},
+      m_region{region},
+      m_texture_owner{std::move(texture_owner)} {}
+
 Image::Image(Image&& image) noexcept
-    : m_context{image.m_context}, m_handle{image.m_handle} {
+    : m_context{image.m_context},
+      m_handle{image.m_handle},
+      m_region{image.m_region},
+      m_texture_owner{std::move(image.m_texture_owner)} {
   image.m_context = nullptr;
   image.m_handle = std::nullopt;
+  image.m_region = std::nullopt;
 }
 
 Image::~Image() noexcept {
-  if (isImageLoaded()) {
+  if (isImageLoaded() && !m_texture_owner) {
     nvgDeleteImage(m_context.get(), *m_handle);
   }
 }
 
 Image& Image::operator=(Image&& image) noexcept {
+  if (this == &image) {
+    return *this;
+  }
+  if (isImageLoaded() && !m_texture_owner) {
+    nvgDeleteImage(m_context.get(), *m_handle);
+  }
   m_context = image.m_context;
   m_handle = image.m_handle;
+  m_region = image.m_region;
+  m_texture_owner = std::move(image.m_texture_owner);
   image.m_context = nullptr;
   image.m_handle = std::nullopt;
+  image.m_region = std::nullopt;
   return *this;
 }
 
@@ -36,6 +57,14 @@ std::optional<ImageHandle> Image::getHandle() const noexcept {
 }
 
 std::pair<int, int> Image::getSize() const noexcept {
+  if (m_region) {
+    return {static_cast<int>(m_region->width),
+            static_cast<int>(m_region->height)};
+  }
+  return getTextureSize();
+}
+
+std::pair<int, int> Image::getTextureSize() const noexcept {
   if (!isImageLoaded()) {
     return {0, 0};
   }
@@ -45,6 +74,41 @@ std::pair<int, int> Image::getSize() const noexcept {
   return {width, height};
 }
 
+int Image::getChannelCount() const noexcept {
+  int type{0};
+  int image_flags{0};
+
+  if (!isImageLoaded() ||
+      !nvgImageFormat(m_context.get(), *m_handle, &type, &image_flags)) {
+    return 0;
+  }
+  return type == NVG_TEXTURE_ALPHA ? 1 : 4;
+}
+
+int Image::getImageFlags() const noexcept {
+  int type{0};
+  int image_flags{0};
+
+  if (!isImageLoaded() ||
+      !nvgImageFormat(m_context.get(), *m_handle, &type, &image_flags)) {
+    return 0;
+  }
+  return image_flags;
+}
+
+Rect Image::getRegion() const noexcept {
+  if (m_region) {
+    return *m_region;
+  }
+  const auto size{getTextureSize()};
+  return {0, 0, static_cast<float>(size.first),
+          static_cast<float>(size.second)};
+}
+
+bool Image::isSharedTexture() const noexcept {
+  return m_texture_owner != nullptr;
+}
+
 bool Image::isImageLoaded() const noexcept {
   return nullptr != m_context && m_handle;
 }
@@ -0,0 +1,124 @@
+#include "dana/image_cache.h"
+
+#include "dana/types.h"
+
+namespace dana {
+
+static std::size_t getTextureBytes(const Image& image) noexcept {
+  const auto size{image.getSize()};
+  const auto bytes{static_cast<std::size_t>(size.first) * size.second *
+                   image.getChannelCount()};
+
+  // A full mip chain adds a third
+  return (image.getImageFlags() & IMAGE_GENERATE_MIPMAPS) != 0
+             ? bytes + bytes / 3
+             : bytes;
+}
+
+const Image& CachedImage::get() const noexcept {
+  static const Image empty;
+  return m_cache != nullptr ? m_cache->use(*m_entry) : empty;
+}
+
+bool CachedImage::isResident() const noexcept {
+  return m_entry && m_entry->resident;
+}
+
+ImageCache::ImageCache(Pencil& pencil, const std::size_t budget) noexcept
+    : m_pencil{pencil}, m_budget{budget} {}
+
+CachedImage ImageCache::get(const std::string& filename,
+                            const int image_flags) noexcept {
+  // The flags change the texture, so they are part of the key
+  return get(filename + "#" + std::to_string(image_flags),
+             [filename, image_flags](Pencil& pencil) {
+               return pencil.createImage(filename, image_flags);
+             });
+}
+
+CachedImage ImageCache::get(const std::string& key,
+                            std::function<Image(Pencil&)> load) noexcept {
+  auto& entry{m_entries[key]};
+
+  if (!entry) {
+    entry = std::make_shared<Entry>();
+    entry->load = std::move(load);
+  }
+  CachedImage image;
+  image.m_cache = this;
+  image.m_entry = entry;
+  use(*entry);
+  return image;
+}
+
+ImageCache& ImageCache::setBudget(const std::size_t budget) noexcept {
+  m_budget = budget;
+  evict();
+  return *this;
+}
+
+std::size_t ImageCache::getBudget() const noexcept {
+  return m_budget;
+}
+
+std::size_t ImageCache::getResidentBytes() const noexcept {
+  return m_resident_bytes;
+}
+
+std::size_t ImageCache::getImageCount() const noexcept {
+  return m_entries.size();
+}
+
+uint64_t ImageCache::getHitCount() const noexcept {
+  return m_hits;
+}
+
+uint64_t ImageCache::getMissCount() const noexcept {
+  return m_misses;
+}
+
+uint64_t ImageCache::getEvictionCount() const noexcept {
+  return m_evictions;
+}
+
+const Image& ImageCache::use(Entry& entry) noexcept {
+  entry.last_use_frame = m_pencil.getFrameCount();
+
+  if (entry.resident) {
+    ++m_hits;
+    m_lru.splice(m_lru.begin(), m_lru, entry.lru_position);
+  } else {
+    ++m_misses;
+    entry.image = entry.load(m_pencil);
+
+    if (entry.image.getHandle()) {
+      // Images in a shared texture only account for their region
+      entry.bytes = getTextureBytes(entry.image);
+      entry.resident = true;
+      entry.lru_position = m_lru.insert(m_lru.begin(), &entry);
+      m_resident_bytes += entry.bytes;
+    }
+  }
+  // Images kept for the previous frame can go once it is done
+  evict();
+  return entry.image;
+}
+
+void ImageCache::evict() noexcept {
+  const auto frame{m_pencil.getFrameCount()};
+
+  while (m_resident_bytes > m_budget && !m_lru.empty()) {
+    auto* entry{m_lru.back()};
+
+    // The rest has been drawn in this frame too, and is still needed
+    if (entry->last_use_frame == frame) {
+      break;
+    }
+    m_lru.pop_back();
+    m_resident_bytes -= entry->bytes;
+    entry->image = Image();
+    entry->resident = false;
+    ++m_evictions;
+  }
+}
+}  // namespace dana
@@ -0,0 +1,168 @@
+#include "dana/image_data.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace dana {
+
+// Rectangles that share an edge are merged too, which keeps their count down
+static bool touches(const Rect& a, const Rect& b) noexcept {
+  return a.x <= b.x + b.width && b.x <= a.x + a.width &&
+         a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+static Rect unite(const Rect& a, const Rect& b) noexcept {
+  const float left{std::min(a.x, b.x)};
+  const float top{std::min(a.y, b.y)};
+  const float right{std::max(a.x + a.width, b.x + b.width)};
+  const float bottom{std::max(a.y + a.height, b.y + b.height)};
+  return {left, top, right - left, bottom - top};
+}
+
+ImageData::ImageData(const int width, const int height)
+    : m_width{std::max(width, 0)},
+      m_height{std::max(height, 0)},
+      m_pixels(static_cast<std::size_t>(m_width) * m_height * 4, 0) {
+  markAllDirty();
+}
+
+std::pair<int, int> ImageData::getSize() const noexcept {
+  return {m_width, m_height};
+}
+
+unsigned char* ImageData::getPixels() noexcept {
+  return m_pixels.data();
+}
+
+const unsigned char* ImageData::getPixels() const noexcept {
+  return m_pixels.data();
+}
+
+Color ImageData::getPixel(const int x, const int y) const noexcept {
+  if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+    return {0, 0, 0, 0};
+  }
+  const auto* pixel{&m_pixels[(static_cast<std::size_t>(y) * m_width + x) * 4]};
+  return {pixel[0], pixel[1], pixel[2], pixel[3]};
+}
+
+ImageData& ImageData::setPixel(const int x, const int y,
+                               const Color& color) noexcept {
+  if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+    return *this;
+  }
+  auto* pixel{&m_pixels[(static_cast<std::size_t>(y) * m_width + x) * 4]};
+  pixel[0] = color.r;
+  pixel[1] = color.g;
+  pixel[2] = color.b;
+  pixel[3] = color.a;
+  return markDirty({static_cast<float>(x), static_cast<float>(y), 1, 1});
+}
+
+ImageData& ImageData::fill(const Rect& rect, const Color& color) noexcept {
+  const int left{std::max(static_cast<int>(std::floor(rect.x)), 0)};
+  const int top{std::max(static_cast<int>(std::floor(rect.y)), 0)};
+  const int right{
+      std::min(static_cast<int>(std::ceil(rect.x + rect.width)), m_width)};
+  const int bottom{
+      std::min(static_cast<int>(std::ceil(rect.y + rect.height)), m_height)};
+
+  for (int y = top; y < bottom; ++y) {
+    auto* pixel{&m_pixels[(static_cast<std::size_t>(y) * m_width + left) * 4]};
+
+    for (int x = left; x < right; ++x, pixel += 4) {
+      pixel[0] = color.r;
+      pixel[1] = color.g;
+      pixel[2] = color.b;
+      pixel[3] = color.a;
+    }
+  }
+  return markDirty(rect);
+}
+
+ImageData& ImageData::putPixels(const int x, const int y, const int width,
+                                const int height, const int stride,
+                                const unsigned char* pixels) noexcept {
+  const int left{std::max(x, 0)};
+  const int top{std::max(y, 0)};
+  const int right{std::min(x + width, m_width)};
+  const int bottom{std::min(y + height, m_height)};
+
+  if (pixels == nullptr || left >= right || top >= bottom) {
+    return *this;
+  }
+  for (int row = top; row < bottom; ++row) {
+    const auto* source{
+        pixels + (static_cast<std::size_t>(row - y) * stride + left - x) * 4};
+    std::memcpy(&m_pixels[(static_cast<std::size_t>(row) * m_width + left) * 4],
+                source, static_cast<std::size_t>(right - left) * 4);
+  }
+  return markDirty({static_cast<float>(left), static_cast<float>(top),
+                    static_cast<float>(right - left),
+                    static_cast<float>(bottom - top)});
+}
+
+ImageData& ImageData::markDirty(const Rect& rect) noexcept {
+  const float left{std::max(std::floor(rect.x), 0.0f)};
+  const float top{std::max(std::floor(rect.y), 0.0f)};
+  const float right{
+      std::min(std::ceil(rect.x + rect.width), static_cast<float>(m_width))};
+  const float bottom{
+      std::min(std::ceil(rect.y + rect.height), static_cast<float>(m_height))};
+
+  if (left >= right || top >= bottom) {
+    return *this;
+  }
+  Rect dirty{left, top, right - left, bottom - top};
+
+  // Merging can make the rectangle touch others it did not touch before, so
+  // keep merging until it touches none
+  for (auto it = m_dirty_rects.begin(); it != m_dirty_rects.end();) {
+    if (touches(*it, dirty)) {
+      dirty = unite(*it, dirty);
+      m_dirty_rects.erase(it);
+      it = m_dirty_rects.begin();
+    } else {
+      ++it;
+    }
+  }
+  m_dirty_rects.push_back(dirty);
+
+  if (m_dirty_rects.size() > max_dirty_rects) {
+    for (const auto& other : m_dirty_rects) {
+      dirty = unite(dirty, other);
+    }
+    m_dirty_rects = {dirty};
+  }
+  return *this;
+}
+
+ImageData& ImageData::markAllDirty() noexcept {
+  return markDirty({0, 0, static_cast<float>(m_width),
+                    static_cast<float>(m_height)});
+}
+
+ImageData& ImageData::clearDirty() noexcept {
+  m_dirty_rects.clear();
+  return *this;
+}
+
+bool ImageData::isDirty() const noexcept {
+  return !m_dirty_rects.empty();
+}
+
+const std::vector<Rect>& ImageData::getDirtyRects() const noexcept {
+  return m_dirty_rects;
+}
+
+std::size_t ImageData::getDirtyBytes() const noexcept {
+  std::size_t bytes{0};
+
+  for (const auto& rect : m_dirty_rects) {
+    bytes += static_cast<std::size_t>(rect.width) *
+             static_cast<std::size_t>(rect.height) * 4;
+  }
+  return bytes;
+}
+}  // namespace dana
@@ -0,0 +1,204 @@
+#include "dana/image_loader.h"
+
+#include <nanovg/stb_image.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace dana {
+
+static std::vector<unsigned char> downsize(
+    const std::vector<unsigned char>& pixels, const int width,
+    const int height, const int new_width, const int new_height) {
+  std::vector<unsigned char> result(
+      static_cast<std::size_t>(new_width) * new_height * 4);
+
+  // Averages the block of source pixels each new pixel covers
+  for (int y = 0; y < new_height; ++y) {
+    const int top{y * height / new_height};
+    const int bottom{std::max((y + 1) * height / new_height, top + 1)};
+
+    for (int x = 0; x < new_width; ++x) {
+      const int left{x * width / new_width};
+      const int right{std::max((x + 1) * width / new_width, left + 1)};
+      unsigned int sums[4]{0, 0, 0, 0};
+
+      for (int row = top; row < bottom; ++row) {
+        const auto* pixel{&pixels[(row * width + left) * 4]};
+
+        for (int column = left; column < right; ++column, pixel += 4) {
+          sums[0] += pixel[0];
+          sums[1] += pixel[1];
+          sums[2] += pixel[2];
+          sums[3] += pixel[3];
+        }
+      }
+      const unsigned int count = (bottom - top) * (right - left);
+      auto* target{&result[(y * new_width + x) * 4]};
+
+      for (int i = 0; i < 4; ++i) {
+        target[i] = static_cast<unsigned char>((sums[i] + count / 2) / count);
+      }
+    }
+  }
+  return result;
+}
+
+static void premultiply(std::vector<unsigned char>& pixels) noexcept {
+  for (std::size_t i = 0; i < pixels.size(); i += 4) {
+    const unsigned int alpha{pixels[i + 3]};
+
+    for (std::size_t j = i; j < i + 3; ++j) {
+      pixels[j] = static_cast<unsigned char>((pixels[j] * alpha + 127) / 255);
+    }
+  }
+}
+
+static bool decode(const std::string& filename, const ImageLoadOptions& options,
+                   std::vector<unsigned char>& pixels, int& width,
+                   int& height) {
+  int components{0};
+  const c_unique_ptr<unsigned char> data{
+      stbi_load(filename.c_str(), &width, &height, &components, 4),
+      [](unsigned char* ptr) { stbi_image_free(ptr); }};
+
+  if (!data) {
+    return false;
+  }
+  pixels.assign(data.get(), data.get() + width * height * 4);
+
+  float scale{1};
+
+  if (options.max_width > 0 && width > options.max_width) {
+    scale = std::min(scale, static_cast<float>(options.max_width) / width);
+  }
+  if (options.max_height > 0 && height > options.max_height) {
+    scale = std::min(scale, static_cast<float>(options.max_height) / height);
+  }
+  if (scale < 1) {
+    const int new_width{std::max(static_cast<int>(width * scale), 1)};
+    const int new_height{std::max(static_cast<int>(height * scale), 1)};
+    pixels = downsize(pixels, width, height, new_width, new_height);
+    width = new_width;
+    height = new_height;
+  }
+  if (options.premultiply) {
+    premultiply(pixels);
+  }
+  return true;
+}
+
+ImageStatus AsyncImage::getStatus() const noexcept {
+  return m_state ? m_state->status.load() : ImageStatus::FAILED;
+}
+
+bool AsyncImage::isReady() const noexcept {
+  return getStatus() == ImageStatus::READY;
+}
+
+const Image& AsyncImage::getImage() const noexcept {
+  static const Image empty;
+
+  if (!m_state) {
+    return empty;
+  }
+  if (m_state->status == ImageStatus::READY) {
+    return m_state->image;
+  }
+  return m_state->placeholder ? *m_state->placeholder : empty;
+}
+
+ImageLoader::ImageLoader(Pencil& pencil, ThreadPool& thread_pool,
+                         std::function<void()> notify)
+    : m_pencil{pencil},
+      m_thread_pool{thread_pool},
+      m_queue{std::make_shared<Queue>()} {
+  m_queue->notify = std::move(notify);
+  setPlaceholderColor({0, 0, 0, 0});
+}
+
+ImageLoader::~ImageLoader() noexcept {
+  m_queue->cancelled = true;
+}
+
+AsyncImage ImageLoader::createImageAsync(const std::string& filename,
+                                         const int image_flags,
+                                         const ImageLoadOptions& options) {
+  AsyncImage image;
+  image.m_state = std::make_shared<AsyncImage::State>();
+  image.m_state->placeholder = m_placeholder;
+
+  // The task only holds on to the queue, so the loader can go away while
+  // images are still being decoded
+  m_thread_pool.submit([queue = m_queue, state = image.m_state, filename,
+                        image_flags, options] {
+    if (queue->cancelled) {
+      return;
+    }
+    Decoded decoded{state, {}, 0, 0, image_flags};
+
+    if (!decode(filename, options, decoded.pixels, decoded.width,
+                decoded.height)) {
+      state->status = ImageStatus::FAILED;
+      return;
+    }
+    if (options.premultiply) {
+      decoded.image_flags |= IMAGE_PREMULTIPLIED;
+    }
+    {
+      std::lock_guard<std::mutex> lock(queue->mutex);
+      queue->decoded.push_back(std::move(decoded));
+    }
+    if (queue->notify) {
+      queue->notify();
+    }
+  });
+  return image;
+}
+
+ImageLoader& ImageLoader::setPlaceholderColor(const Color& color) noexcept {
+  const unsigned char pixel[4]{color.r, color.g, color.b, color.a};
+  m_placeholder =
+      std::make_shared<const Image>(m_pencil.createImage(1, 1, pixel, 0));
+  return *this;
+}
+
+ImageLoader& ImageLoader::setUploadBudget(
+    const std::chrono::microseconds budget) noexcept {
+  m_upload_budget = budget;
+  return *this;
+}
+
+bool ImageLoader::hasPendingUploads() const noexcept {
+  std::lock_guard<std::mutex> lock(m_queue->mutex);
+  return !m_queue->decoded.empty();
+}
+
+std::size_t ImageLoader::upload() noexcept {
+  const auto begin_time{std::chrono::steady_clock::now()};
+  std::size_t count{0};
+
+  do {
+    Decoded decoded;
+    {
+      std::lock_guard<std::mutex> lock(m_queue->mutex);
+
+      if (m_queue->decoded.empty()) {
+        break;
+      }
+      decoded = std::move(m_queue->decoded.front());
+      m_queue->decoded.pop_front();
+    }
+    auto& state{*decoded.state};
+    state.image = m_pencil.createImage(decoded.width, decoded.height,
+                                       decoded.pixels.data(),
+                                       decoded.image_flags);
+    state.status = state.image.getHandle().value_or(0) != 0
+                       ? ImageStatus::READY
+                       : ImageStatus::FAILED;
+    ++count;
+  } while (std::chrono::steady_clock::now() - begin_time < m_upload_budget);
+
+  return count;
+}
+}  // namespace dana
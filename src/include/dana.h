@@ -1,7 +1,28 @@
 #pragma once
 
+#include "dana/asset_pack.h"
 #include "dana/canvas.h"
+#include "dana/damage_region.h"
+#include "dana/device.h"
 #include "dana/events.h"
+#include "dana/fixed_timestep.h"
+#include "dana/frame_exporter.h"
+#include "dana/frame_scheduler.h"
+#include "dana/frame_statistics.h"
+#include "dana/framebuffer.h"
+#include "dana/framebuffer_pool.h"
+#include "dana/image_cache.h"
+#include "dana/image_data.h"
+#include "dana/image_loader.h"
+#include "dana/layer.h"
+#include "dana/path.h"
 #include "dana/pencil.h"
+#include "dana/picture.h"
+#include "dana/readback.h"
+#include "dana/redraw_scheduler.h"
+#include "dana/sprite_batch.h"
+#include "dana/spsc_queue.h"
+#include "dana/texture_atlas.h"
+#include "dana/thread_pool.h"
 #include "dana/types.h"
 #include "dana/util.h"
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dana {
+
+enum class PixelFormat { RGBA, ALPHA };
+
+/// An image in an asset pack. The pixels point into the pack, and stay valid
+/// as long as the pack is open.
+struct PackedImage {
+  PixelFormat format{PixelFormat::RGBA};
+  int width{0};
+  int height{0};
+
+  /// The image flags the image was packed with, such as premultiplied alpha.
+  int image_flags{0};
+
+  /// The mip chain, starting with the full size image. Every level is half
+  /// the size of the previous one, rounded down but at least one pixel.
+  std::vector<const unsigned char*> levels;
+};
+
+/// How an image is prepared while it is packed.
+struct AssetPackOptions {
+  /// Packs one channel per pixel instead of four. Images from file keep their
+  /// luminance, and are drawn as a coverage mask.
+  PixelFormat format{PixelFormat::RGBA};
+
+  /// Packs a full mip chain, so mipmaps are not generated when loading.
+  bool mipmaps{true};
+
+  /// Multiplies the colors by alpha, and marks the image as premultiplied.
+  bool premultiply{false};
+};
+
+/// A file of decoded images, which is memory mapped so images are uploaded
+/// straight from the file without decoding or copying them first.
+///
+/// A pack starts with an index of named images, followed by the pixels of
+/// each image and its mip levels. The pixels of every image start at a page
+/// boundary. Packs are written by AssetPackWriter, in the byte order of the
+/// machine writing them.
+class AssetPack {
+  const unsigned char* m_data{nullptr};
+  std::size_t m_size{0};
+  std::unordered_map<std::string, PackedImage> m_images;
+
+ public:
+  static constexpr std::size_t page_size{4096};
+
+  /// Maps a pack file. The pack is closed if the file cannot be mapped or is
+  /// not a valid pack.
+  explicit AssetPack(const std::string& filename) noexcept;
+
+  ~AssetPack() noexcept;
+
+  bool isOpen() const noexcept;
+
+  std::size_t getImageCount() const noexcept;
+
+  std::vector<std::string> getImageNames() const;
+
+  /// Returns the image with a given name, or null if there is none.
+  const PackedImage* find(const std::string& name) const noexcept;
+
+ protected:
+  AssetPack(const AssetPack&) = delete;
+
+  AssetPack& operator=(const AssetPack&) = delete;
+
+ private:
+  bool readIndex() noexcept;
+
+  void close() noexcept;
+};
+
+/// Builds an asset pack from image files or pixels, for use by an offline
+/// packer.
+class AssetPackWriter {
+  struct Image {
+    std::string name;
+    PixelFormat format;
+    int width;
+    int height;
+    int image_flags;
+    std::vector<std::vector<unsigned char>> levels;
+  };
+
+  std::vector<Image> m_images;
+
+ public:
+  AssetPackWriter() noexcept = default;
+
+  /// Decodes an image file and adds it to the pack. Returns false if the file
+  /// could not be decoded.
+  bool addImage(const std::string& name, const std::string& filename,
+                const AssetPackOptions& options = {});
+
+  /// Adds an image from pixels in the given format of the options.
+  AssetPackWriter& addImage(const std::string& name, int width, int height,
+                            const unsigned char* pixels,
+                            const AssetPackOptions& options = {});
+
+  std::size_t getImageCount() const noexcept;
+
+  /// Writes the pack to file. Returns false if it could not be written.
+  bool write(const std::string& filename) const;
+
+ protected:
+  AssetPackWriter(const AssetPackWriter&) = delete;
+
+  AssetPackWriter& operator=(const AssetPackWriter&) = delete;
+};
+}  // namespace dana
@@ -1,40 +1,105 @@
 #pragma once
 
+#include "dana/damage_region.h"
+#include "dana/device.h"
 #include "dana/events.h"
+#include "dana/fixed_timestep.h"
+#include "dana/frame_exporter.h"
+#include "dana/frame_scheduler.h"
+#include "dana/frame_statistics.h"
+#include "dana/framebuffer.h"
+#include "dana/layer.h"
 #include "dana/pencil.h"
+#include "dana/picture.h"
+#include "dana/readback.h"
+#include "dana/redraw_scheduler.h"
 #include "dana/types.h"
 #include "dana/util.h"
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 struct SDL_Window;
 union SDL_Event;
 
 namespace dana {
 
-/// The callback type used to draw graphics onto a canvas.
-using DrawCallback = std::function<void(Pencil&)>;
+/// The callback type used to draw graphics onto a canvas with an interpolation
+/// factor between the previous and the latest simulation step.
+using InterpolatedDrawCallback = std::function<void(Pencil&, float)>;
+
+/// The callback type used to record one chunk of a frame into a picture. It is
+/// given the index of the chunk.
+using RecordCallback = std::function<void(Picture&, std::size_t)>;
+
+/// The callback type used to advance the simulation by a fixed time step,
+/// given in seconds.
+using UpdateCallback = std::function<void(float)>;
 
 /// The callback type used to handle keyboard, mouse and window events.
 using EventCallback = std::function<void(const Event&)>;
 
 class Canvas {
+  friend class Device;
+
+  std::shared_ptr<Device> m_device{nullptr};
   c_unique_ptr<SDL_Window> m_window{nullptr};
-  c_unique_ptr<void> m_gl_context{nullptr};
+  uint32_t m_window_id{0};
+  std::unique_ptr<Framebuffer> m_framebuffer{nullptr};
+  std::unique_ptr<Framebuffer> m_back_buffer{nullptr};
+  std::unique_ptr<Readback> m_readback{nullptr};
+  ReadbackCallback m_readback_callback{nullptr};
+  std::shared_ptr<FrameExporter> m_frame_exporter{nullptr};
+  std::size_t m_readback_buffers{3};
 
-  DrawCallback m_draw_callback{[](Pencil&) {}};
+  InterpolatedDrawCallback m_draw_callback{[](Pencil&, float) {}};
   EventCallback m_event_callback{[](const Event&) {}};
+  UpdateCallback m_update_callback{nullptr};
+  RecordCallback m_record_callback{nullptr};
+  std::vector<Picture> m_pictures;
+  FixedTimestep m_timestep;
 
   bool m_show{true};
   Color m_clear_color;
-  long m_performance{0};
+  FrameStatistics m_statistics;
+  uint64_t m_frame_count{0};
+
+  RedrawScheduler m_redraw{[this] { m_device->wakeUp(); }};
+
+  bool m_partial_redraw{false};
+  DamageRegion m_damage;
+  std::mutex m_damage_mutex;
+  Rect m_redraw_area;
+
+  std::vector<std::shared_ptr<Layer>> m_layers;
 
  public:
   /// Constructs a canvas window with a given width and height, and a title
-  /// text.
+  /// text. The canvas gets a device of its own.
   Canvas(int width, int height, const std::string& title);
 
+  /// Constructs a headless canvas that renders into an offscreen framebuffer
+  /// of a given width and height. The canvas gets a headless device of its
+  /// own, so no display server is needed. Frames are rendered one at a time by
+  /// calling renderFrame(), unpaced and without vsync.
+  Canvas(int width, int height, HeadlessMode);
+
+  /// Constructs a canvas window that shares the context, pencil and event
+  /// loop of a device with the other canvases created on it.
+  Canvas(const std::shared_ptr<Device>& device, int width, int height,
+         const std::string& title);
+
+  /// Constructs a headless canvas that shares the context and pencil of a
+  /// device with the other canvases created on it.
+  Canvas(const std::shared_ptr<Device>& device, int width, int height,
+         HeadlessMode);
+
   ~Canvas() noexcept;
 
   /// Sets the clear color that is used to clear the screen for each frame
@@ -44,19 +109,178 @@ class Canvas {
   /// Sets the graphics callback that is called for each frame.
   Canvas& onNewFrame(const DrawCallback& draw_callback) noexcept;
 
+  /// Sets a graphics callback that is called for each frame with the fraction
+  /// of an update step that has passed since the latest update. Drawing the
+  /// state interpolated between the previous and the latest update by that
+  /// factor keeps motion smooth when the frame rate and update rate differ.
+  /// The factor is 1 when no update callback is set.
+  Canvas& onNewFrame(const InterpolatedDrawCallback& draw_callback) noexcept;
+
+  /// Sets a callback that records a frame in chunks on the worker threads of
+  /// the device. Each chunk is recorded into a picture of its own, and the
+  /// pictures are replayed in chunk order after the draw callback, so the
+  /// result does not depend on which thread recorded which chunk. The state
+  /// of the pencil is saved and restored around each chunk. The callback must
+  /// not change state shared between chunks. An empty callback disables
+  /// parallel recording.
+  Canvas& onParallelFrame(std::size_t chunk_count,
+                          const RecordCallback& record_callback);
+
+  /// Sets a callback that advances the simulation by a fixed time step. It is
+  /// called before drawing as many times as needed to catch up with the time
+  /// passed since the previous frame, but no more than the max update steps
+  /// per frame. An empty callback disables updates.
+  Canvas& onUpdate(const UpdateCallback& update_callback) noexcept;
+
+  /// Sets the number of times per second the update callback is called.
+  Canvas& setUpdateRate(double update_rate) noexcept;
+
+  /// Sets the largest number of updates per frame. Time beyond that is
+  /// dropped, so the simulation slows down instead of falling further behind.
+  Canvas& setMaxUpdateSteps(std::size_t max_steps) noexcept;
+
+  /// Returns the timestep that paces the update callback.
+  const FixedTimestep& getTimestep() const noexcept;
+
   /// Sets the event handler callback that is used to catch keyboard, mouse and
   /// window events.
   Canvas& onEvent(const EventCallback& event_callback) noexcept;
 
-  /// Shows the canvas window on screen.
+  /// Sets the number of frames per second the canvas is paced to. Time spent
+  /// rendering a frame is subtracted from the sleep before the next one. A
+  /// frame rate of zero or less disables pacing. Pacing is shared by all
+  /// canvases of a device.
+  Canvas& setTargetFrameRate(double frame_rate) noexcept;
+
+  /// Sets how buffer swaps are synchronized with the display refresh. Falls
+  /// back to regular vsync if adaptive vsync is not supported, and to immediate
+  /// swaps if vsync is not supported at all. The swap interval is shared by
+  /// all canvases of a device.
+  Canvas& setSwapInterval(SwapIntervals swap_interval) noexcept;
+
+  /// Returns the swap interval that is actually in effect.
+  SwapIntervals getSwapInterval() const noexcept;
+
+  /// Disables both frame pacing and vsync, rendering frames as fast as
+  /// possible. Useful for benchmarks. Affects all canvases of a device.
+  Canvas& setUncapped() noexcept;
+
+  /// Renders on a thread of its own while show() pumps events, see
+  /// Device::setThreadedRendering(). Affects all canvases of a device.
+  Canvas& setThreadedRendering(bool enabled) noexcept;
+
+  /// Sets when the canvas renders new frames. Regardless of the mode, nothing
+  /// is rendered while the window is hidden or minimized.
+  Canvas& setRedrawMode(RedrawModes redraw_mode) noexcept;
+
+  /// Sets the longest time an on-demand canvas waits before redrawing even if
+  /// it has not been invalidated. An interval of zero disables the timer.
+  Canvas& setRedrawInterval(std::chrono::milliseconds redraw_interval) noexcept;
+
+  /// Requests a new frame to be rendered by an on-demand canvas, and marks the
+  /// whole canvas as damaged. Can be called from any thread.
+  void invalidate() noexcept;
+
+  /// Requests a new frame and marks a rectangle of the canvas, in window
+  /// coordinates, as damaged. Can be called from any thread.
+  void invalidate(const Rect& rect) noexcept;
+
+  /// Enables redrawing only the damaged part of the canvas. The clear and the
+  /// draw callback are then clipped to the bounding box of the rectangles
+  /// passed to invalidate() since the previous frame, and the rest of the
+  /// previous frame is kept. Frames without damage skip the draw callback.
+  /// Windows render into an offscreen buffer that is copied to the window, as
+  /// a window's back buffer does not survive the swap.
+  Canvas& setPartialRedraw(bool enabled) noexcept;
+
+  /// Returns true if only the damaged part of the canvas is redrawn.
+  bool isPartialRedraw() const noexcept;
+
+  /// Returns the part of the canvas, in window coordinates, redrawn by the
+  /// current or most recent frame. Draw callbacks can skip anything outside of
+  /// it.
+  Rect getRedrawArea() const noexcept;
+
+  /// Creates a layer of a given size in window coordinates that is composited
+  /// onto the canvas every frame, until it is removed. Changing the layer
+  /// requests a new frame.
+  std::shared_ptr<Layer> createLayer(int width, int height);
+
+  /// Stops compositing a layer and returns its framebuffer to the pool.
+  void removeLayer(const std::shared_ptr<Layer>& layer) noexcept;
+
+  /// Sets a callback that receives the pixels of every rendered frame. Frames
+  /// are read asynchronously through a ring of pixel buffers, so the pixels of
+  /// a frame arrive up to buffer_count - 1 frames later without stalling the
+  /// pipeline. An empty callback disables readback.
+  Canvas& onFrameReadback(const ReadbackCallback& readback_callback,
+                          std::size_t buffer_count = 3);
+
+  /// Sets an exporter that encodes every rendered frame on its worker threads.
+  /// Frames are read back the same way as for onFrameReadback(), and both can
+  /// be used at the same time. A null exporter disables exporting.
+  Canvas& setFrameExporter(const std::shared_ptr<FrameExporter>& exporter);
+
+  /// Waits until the pixels of all rendered frames have been handed to the
+  /// readback callback and frame exporter.
+  void flushReadbacks() noexcept;
+
+  /// Returns the number of frames rendered so far.
+  uint64_t getFrameCount() const noexcept;
+
+  /// Shows the canvas window on screen, along with the windows of the other
+  /// canvases of its device, and runs the device event loop until they are
+  /// closed. Does nothing for headless canvases.
   void show() noexcept;
 
+  /// Renders a single frame right away, regardless of frame pacing and redraw
+  /// mode.
+  void renderFrame() noexcept;
+
+  /// Returns true if the canvas renders offscreen without a window.
+  bool isHeadless() const noexcept;
+
+  /// Returns the device the canvas renders with.
+  Device& getDevice() const noexcept;
+
   /// Returns the number of milliseconds it took to render the previous frame.
-  /// Can be used to measure performance of your application.
+  /// Prefer getFrameStatistics() for sub-millisecond resolution and per-phase
+  /// timings.
   long getPerformance() const noexcept;
 
+  /// Returns the timings of the most recently rendered frames, split into the
+  /// phases of the frame. The timings measure CPU time spent issuing work, so
+  /// waiting for the GPU typically shows up in the swap phase.
+  const FrameStatistics& getFrameStatistics() const noexcept;
+
+  /// Sets the number of frames kept in the frame statistics. Discards all
+  /// samples.
+  Canvas& setFrameStatisticsWindow(std::size_t frames);
+
  private:
-  void pollEvents(SDL_Event& event) noexcept;
+  void drawFrame(std::chrono::steady_clock::time_point begin_time,
+                 bool synchronize_swap = true) noexcept;
+
+  void updateReadback();
+
+  void handleEvent(const SDL_Event& event) noexcept;
+
+  bool isFrameDue(std::chrono::steady_clock::time_point now) const noexcept;
+
+  int getEventTimeout(std::chrono::steady_clock::time_point now) const noexcept;
+
+  void updateRedrawArea(int d_width, int d_height, int w_width, int w_height);
+
+  void setClipRect(Pencil& pencil, float pixel_ratio, int d_height) const
+      noexcept;
+
+  void damageAll() noexcept;
+
+  void drawPictures(Pencil& pencil);
+
+  void renderLayers(Pencil& pencil, float pixel_ratio);
+
+  void compositeLayers(Pencil& pencil, bool above) const noexcept;
 
   void clearWindow() const noexcept;
 };
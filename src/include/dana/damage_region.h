@@ -0,0 +1,36 @@
+#pragma once
+
+#include "dana/types.h"
+
+namespace dana {
+
+/// Collects the parts of a canvas that changed since the previous frame, so
+/// only those have to be cleared and redrawn. Rectangles are merged into their
+/// bounding box, which keeps the redraw to a single scissor rectangle.
+class DamageRegion {
+  Rect m_bounds;
+  bool m_empty{true};
+  bool m_full{false};
+
+ public:
+  /// Marks a rectangle as damaged. Rectangles without area are ignored.
+  void add(const Rect& rect) noexcept;
+
+  /// Marks everything as damaged.
+  void addAll() noexcept;
+
+  /// Returns true if nothing is damaged.
+  bool isEmpty() const noexcept;
+
+  /// Returns true if everything is damaged.
+  bool isFull() const noexcept;
+
+  /// Returns the bounding box of the damaged rectangles clipped to an area, or
+  /// the whole area if everything is damaged. The result has no area if
+  /// nothing inside the area is damaged.
+  Rect getBounds(const Rect& area) const noexcept;
+
+  /// Marks everything as undamaged.
+  void clear() noexcept;
+};
+}  // namespace dana
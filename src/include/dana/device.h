@@ -0,0 +1,162 @@
+#pragma once
+
+#include "dana/frame_scheduler.h"
+#include "dana/framebuffer_pool.h"
+#include "dana/image_loader.h"
+#include "dana/pencil.h"
+#include "dana/spsc_queue.h"
+#include "dana/thread_pool.h"
+#include "dana/util.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct SDL_Window;
+union SDL_Event;
+
+namespace dana {
+
+class Canvas;
+
+/// Tag type for constructing a device or canvas that renders offscreen without
+/// a window.
+struct HeadlessMode {};
+
+/// Passed to device and canvas constructors to render offscreen.
+inline constexpr HeadlessMode headless{};
+
+/// Owns the OpenGL context and the pencil shared by a group of canvases, and
+/// runs the event loop that drives their windows. Resources created with the
+/// device pencil, such as images, can be drawn on every canvas of the device.
+///
+/// All canvases render through a single context that is made current on each
+/// window in turn, since the vertex arrays used by the pencil cannot be shared
+/// between contexts.
+class Device {
+  friend class Canvas;
+
+  c_unique_ptr<SDL_Window> m_window{nullptr};
+  c_unique_ptr<void> m_gl_context{nullptr};
+  std::unique_ptr<Pencil> m_pencil{nullptr};
+  FramebufferPool m_framebuffer_pool;
+  std::unique_ptr<ThreadPool> m_thread_pool{nullptr};
+  std::unique_ptr<ImageLoader> m_image_loader{nullptr};
+  std::vector<Canvas*> m_canvases;
+
+  FrameScheduler m_scheduler;
+  SwapIntervals m_swap_interval{SwapIntervals::IMMEDIATE};
+  SDL_Window* m_swap_window{nullptr};
+  int m_applied_swap_interval{0};
+
+  uint32_t m_invalidate_event{0};
+
+  bool m_threaded_rendering{false};
+  std::atomic<bool> m_render_thread_running{false};
+  std::unique_ptr<SpscQueue<SDL_Event>> m_events{nullptr};
+  std::mutex m_events_mutex;
+  std::condition_variable m_events_received;
+
+ public:
+  /// Constructs a device for canvases with windows on screen.
+  Device();
+
+  /// Constructs a device for headless canvases. SDL's offscreen video driver
+  /// is used when available, so no display server is needed.
+  explicit Device(HeadlessMode);
+
+  ~Device() noexcept;
+
+  /// Returns the pencil that all canvases of the device draw with.
+  Pencil& getPencil() noexcept;
+
+  /// Returns the pool that offscreen layers of all canvases of the device take
+  /// their framebuffers from.
+  FramebufferPool& getFramebufferPool() noexcept;
+
+  /// Returns the pool of worker threads that canvases of the device record
+  /// and prepare work on. The threads are started on first use.
+  ThreadPool& getThreadPool();
+
+  /// Returns the loader that decodes images for all canvases of the device on
+  /// the thread pool. Canvases upload decoded images at the start of their
+  /// frames, and a visible canvas renders frames while images are waiting to
+  /// be uploaded, without being damaged. Canvases that draw the images once
+  /// they are ready are responsible for invalidating the area. Has to be
+  /// called on the rendering thread the first time.
+  ImageLoader& getImageLoader();
+
+  /// Sets the number of frames per second the event loop is paced to. A frame
+  /// rate of zero or less disables pacing.
+  Device& setTargetFrameRate(double frame_rate) noexcept;
+
+  /// Sets how buffer swaps are synchronized with the display refresh. Falls
+  /// back to regular vsync if adaptive vsync is not supported, and to immediate
+  /// swaps if vsync is not supported at all. When several windows render in
+  /// the same iteration, only the last swap waits for vsync, so the loop is
+  /// not slowed down by one refresh per window.
+  Device& setSwapInterval(SwapIntervals swap_interval) noexcept;
+
+  /// Returns the swap interval that is actually in effect.
+  SwapIntervals getSwapInterval() const noexcept;
+
+  /// Disables both frame pacing and vsync.
+  Device& setUncapped() noexcept;
+
+  /// Enables rendering on a thread of its own. The thread calling run() then
+  /// only pumps events, which SDL requires to happen on the main thread, and
+  /// hands them to the render thread through a lock-free queue. The render
+  /// thread owns the context and calls the event and draw callbacks, so a slow
+  /// frame no longer delays event handling. Takes effect on the next run().
+  Device& setThreadedRendering(bool enabled) noexcept;
+
+  /// Returns true if run() renders on a thread of its own.
+  bool isThreadedRendering() const noexcept;
+
+  /// Shows the windows of all canvases of the device and runs the event loop
+  /// until every window is closed. Headless canvases are left alone.
+  void run() noexcept;
+
+  /// Handles all pending events, dispatching window, keyboard and mouse events
+  /// to the canvas they belong to and all other events to every canvas.
+  void pollEvents() noexcept;
+
+ protected:
+  Device(const Device&) = delete;
+
+  Device& operator=(const Device&) = delete;
+
+ private:
+  void createContext();
+
+  void addCanvas(Canvas* canvas);
+
+  void removeCanvas(Canvas* canvas) noexcept;
+
+  void makeCurrent(SDL_Window* window) noexcept;
+
+  void swapWindow(SDL_Window* window, bool synchronize) noexcept;
+
+  void wakeUp() noexcept;
+
+  void render() noexcept;
+
+  bool isRunning() const noexcept;
+
+  void requestUploadFrame() noexcept;
+
+  int getEventTimeout() const noexcept;
+
+  void waitForEvents() noexcept;
+
+  void handleEvents() noexcept;
+
+  void receiveEvent(const SDL_Event& event) noexcept;
+
+  void dispatchEvent(const SDL_Event& event) noexcept;
+};
+}  // namespace dana
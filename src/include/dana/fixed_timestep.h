@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace dana {
+
+/// Splits elapsed time into steps of a fixed duration, so simulation code runs
+/// at the same rate regardless of the frame rate. Time left over after the
+/// last whole step is reported as an interpolation factor for rendering.
+class FixedTimestep {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+ private:
+  Clock::duration m_step{0};
+  std::size_t m_max_steps{5};
+  Clock::duration m_accumulator{0};
+  Clock::time_point m_last_time{};
+  bool m_started{false};
+  uint64_t m_skipped_steps{0};
+
+ public:
+  /// Constructs a timestep running the given number of updates per second.
+  explicit FixedTimestep(double update_rate = 60.0) noexcept;
+
+  /// Sets the number of updates per second. Values of zero or less are
+  /// ignored.
+  void setUpdateRate(double update_rate) noexcept;
+
+  /// Returns the number of updates per second.
+  double getUpdateRate() const noexcept;
+
+  /// Returns the duration of one step in seconds.
+  float getStepSeconds() const noexcept;
+
+  /// Sets the largest number of steps a single call to advance() returns. Time
+  /// beyond that is dropped, so a long stall does not cause an ever growing
+  /// burst of updates.
+  void setMaxSteps(std::size_t max_steps) noexcept;
+
+  /// Returns the largest number of steps a single call to advance() returns.
+  std::size_t getMaxSteps() const noexcept;
+
+  /// Adds the time elapsed since the previous call and returns the number of
+  /// whole steps that are due. The first call only starts the clock.
+  std::size_t advance(Clock::time_point now) noexcept;
+
+  /// Returns how far the time left over is into the next step, from 0 up to
+  /// but not including 1.
+  float getAlpha() const noexcept;
+
+  /// Returns the number of steps dropped because of the step limit.
+  uint64_t getSkippedSteps() const noexcept;
+
+  /// Discards the time left over and restarts the clock on the next call to
+  /// advance().
+  void reset() noexcept;
+};
+}  // namespace dana
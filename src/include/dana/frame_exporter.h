@@ -0,0 +1,97 @@
+#pragma once
+
+#include "dana/readback.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dana {
+
+/// The file formats frames can be exported to. PNG writes one file per frame,
+/// while RAW_RGBA and Y4M write a single stream that can be piped into video
+/// encoders such as ffmpeg.
+enum class FrameFormats { PNG, RAW_RGBA, Y4M };
+
+/// Decides what happens to a frame submitted while the export queue is full.
+enum class QueuePolicies { BLOCK, DROP };
+
+class FrameExporter {
+  struct Frame {
+    uint64_t index{0};
+    int width{0};
+    int height{0};
+    std::vector<unsigned char> pixels;
+  };
+
+  std::string m_path;
+  FrameFormats m_format;
+  QueuePolicies m_policy;
+  std::size_t m_capacity;
+  int m_frame_rate{60};
+
+  std::mutex m_mutex;
+  std::condition_variable m_queue_filled;
+  std::condition_variable m_queue_drained;
+  std::deque<Frame> m_queue;
+  std::vector<std::vector<unsigned char>> m_buffers;
+  std::size_t m_busy_workers{0};
+  bool m_stopping{false};
+
+  std::ofstream m_stream;
+  int m_stream_width{0};
+  int m_stream_height{0};
+
+  std::atomic<uint64_t> m_encoded_frames{0};
+  std::atomic<uint64_t> m_dropped_frames{0};
+
+  std::vector<std::thread> m_workers;
+
+ public:
+  /// Constructs an exporter that encodes frames on worker threads. For PNG the
+  /// path is a prefix that the zero padded frame number and extension are
+  /// appended to, for the stream formats it is the file to write. Throws if
+  /// the stream file cannot be opened.
+  FrameExporter(const std::string& path, FrameFormats format,
+                QueuePolicies policy = QueuePolicies::BLOCK,
+                std::size_t queue_capacity = 8);
+
+  /// Encodes all queued frames before returning.
+  ~FrameExporter() noexcept;
+
+  /// Sets the frame rate written to Y4M stream headers. Has to be set before
+  /// the first frame is submitted.
+  FrameExporter& setFrameRate(int frame_rate) noexcept;
+
+  /// Copies the pixels of a frame into the export queue. Depending on the
+  /// queue policy, this waits for room in a full queue or drops the frame.
+  void submit(const FramePixels& pixels) noexcept;
+
+  /// Waits until all queued frames are encoded.
+  void wait() noexcept;
+
+  /// Returns the number of frames written so far.
+  uint64_t getEncodedFrames() const noexcept;
+
+  /// Returns the number of frames dropped because the queue was full, their
+  /// size did not match the stream, or they could not be written.
+  uint64_t getDroppedFrames() const noexcept;
+
+ protected:
+  FrameExporter(const FrameExporter&) = delete;
+
+  FrameExporter& operator=(const FrameExporter&) = delete;
+
+ private:
+  void work() noexcept;
+
+  bool encode(const Frame& frame) noexcept;
+};
+}  // namespace dana
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+
+namespace dana {
+
+/// Controls how buffer swaps are synchronized with the display refresh.
+enum class SwapIntervals { IMMEDIATE, VSYNC, ADAPTIVE_VSYNC };
+
+class FrameScheduler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+ private:
+  Clock::duration m_frame_period{0};
+  Clock::time_point m_deadline{};
+
+ public:
+  /// Sets the number of frames per second the scheduler paces to. A frame rate
+  /// of zero or less makes the scheduler uncapped.
+  void setTargetFrameRate(double frame_rate) noexcept;
+
+  /// Returns the target frame rate, or zero when uncapped.
+  double getTargetFrameRate() const noexcept;
+
+  /// Returns true if the scheduler never sleeps between frames.
+  bool isUncapped() const noexcept;
+
+  /// Restarts pacing with the next frame deadline one period from now.
+  void reset() noexcept;
+
+  /// Returns the point in time where the next frame is due.
+  Clock::time_point getDeadline() const noexcept;
+
+  /// Sleeps until the next frame deadline and advances it by one period, so the
+  /// time already spent on the frame is subtracted from the sleep. If a frame
+  /// overran by more than one period, the deadline is re-anchored to the
+  /// current time instead of catching up with a burst of frames.
+  void waitForNextFrame() noexcept;
+};
+}  // namespace dana
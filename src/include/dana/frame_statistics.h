@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace dana {
+
+/// The phases of a rendered frame. TOTAL covers all other phases, but not the
+/// time spent sleeping between frames.
+enum class FramePhases {
+  POLL_EVENTS,
+  UPDATE,
+  LAYERS,
+  CLEAR,
+  DRAW,
+  FLUSH,
+  READBACK,
+  SWAP,
+  TOTAL
+};
+
+struct FrameTimeSummary {
+  std::chrono::nanoseconds min{0};
+  std::chrono::nanoseconds mean{0};
+  std::chrono::nanoseconds p50{0};
+  std::chrono::nanoseconds p95{0};
+  std::chrono::nanoseconds p99{0};
+  std::chrono::nanoseconds max{0};
+  std::size_t samples{0};
+};
+
+class FrameStatistics {
+  static constexpr std::size_t phase_count{
+      static_cast<std::size_t>(FramePhases::TOTAL) + 1};
+
+  struct Samples {
+    std::vector<std::chrono::nanoseconds> values;
+    std::size_t next{0};
+  };
+
+  std::size_t m_window_size{0};
+  std::array<Samples, phase_count> m_samples;
+  mutable std::vector<std::chrono::nanoseconds> m_sorted;
+
+ public:
+  /// Constructs statistics that keep the given number of most recent samples
+  /// for each frame phase.
+  explicit FrameStatistics(std::size_t window_size = 240);
+
+  /// Changes the number of samples kept for each phase. Discards all samples.
+  void setWindowSize(std::size_t window_size);
+
+  /// Returns the number of samples kept for each phase.
+  std::size_t getWindowSize() const noexcept;
+
+  /// Adds a sample for a phase, replacing the oldest one if the window is full.
+  void record(FramePhases phase, std::chrono::nanoseconds duration) noexcept;
+
+  /// Returns the most recent sample of a phase, or zero if there is none.
+  std::chrono::nanoseconds getLast(FramePhases phase) const noexcept;
+
+  /// Returns min, mean, percentiles and max over the samples in the window.
+  FrameTimeSummary getSummary(FramePhases phase) const noexcept;
+
+  /// Discards all samples.
+  void clear() noexcept;
+};
+}  // namespace dana
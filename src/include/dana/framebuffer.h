@@ -0,0 +1,51 @@
+#pragma once
+
+#include <utility>
+
+namespace dana {
+
+class Framebuffer {
+  unsigned int m_framebuffer{0};
+  unsigned int m_texture{0};
+  unsigned int m_renderbuffer{0};
+  int m_width{0};
+  int m_height{0};
+
+ public:
+  /// Creates an offscreen framebuffer with an RGBA color texture and a combined
+  /// depth and stencil buffer. Requires a current OpenGL context.
+  Framebuffer(int width, int height);
+
+  Framebuffer(Framebuffer&& framebuffer) noexcept;
+
+  ~Framebuffer() noexcept;
+
+  Framebuffer& operator=(Framebuffer&& framebuffer) noexcept;
+
+  /// Binds the framebuffer as target for both drawing and reading.
+  void bind() const noexcept;
+
+  /// Binds the default framebuffer of the current window.
+  static void unbind() noexcept;
+
+  /// Copies the color buffer to the default framebuffer of the current window
+  /// and leaves the default framebuffer bound.
+  void blitToWindow() const noexcept;
+
+  /// Returns the OpenGL name of the framebuffer object.
+  unsigned int getHandle() const noexcept;
+
+  /// Returns the OpenGL name of the color texture.
+  unsigned int getTexture() const noexcept;
+
+  std::pair<int, int> getSize() const noexcept;
+
+ protected:
+  Framebuffer(const Framebuffer&) = delete;
+
+  Framebuffer& operator=(const Framebuffer&) = delete;
+
+ private:
+  void release() noexcept;
+};
+}  // namespace dana
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "dana/framebuffer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dana {
+
+/// Keeps released framebuffers around for reuse, so offscreen rendering does
+/// not have to create and destroy OpenGL objects whenever a size changes.
+class FramebufferPool {
+  std::vector<std::unique_ptr<Framebuffer>> m_framebuffers;
+  std::size_t m_capacity{16};
+  uint64_t m_created{0};
+  uint64_t m_reused{0};
+
+ public:
+  /// Returns a framebuffer of the given size, reusing a pooled one if there is
+  /// one. Requires a current OpenGL context.
+  std::unique_ptr<Framebuffer> acquire(int width, int height);
+
+  /// Returns a framebuffer to the pool. The least recently released
+  /// framebuffer is destroyed if the pool is full.
+  void release(std::unique_ptr<Framebuffer> framebuffer) noexcept;
+
+  /// Sets the number of unused framebuffers kept in the pool.
+  void setCapacity(std::size_t capacity) noexcept;
+
+  /// Returns the number of unused framebuffers in the pool.
+  std::size_t getSize() const noexcept;
+
+  /// Returns the number of framebuffers created by the pool.
+  uint64_t getCreatedCount() const noexcept;
+
+  /// Returns the number of times a pooled framebuffer was reused.
+  uint64_t getReusedCount() const noexcept;
+
+  /// Destroys all unused framebuffers.
+  void clear() noexcept;
+};
+}  // namespace dana
@@ -11,9 +11,13 @@ struct NVGcontext;
 
 namespace dana {
 
+/// An image in a texture. The image either owns its texture, or is a region
+/// of a texture shared with other images, such as a page of a TextureAtlas.
 class Image {
   std::shared_ptr<NVGcontext> m_context{nullptr};
   std::optional<ImageHandle> m_handle{std::nullopt};
+  std::optional<Rect> m_region{std::nullopt};
+  std::shared_ptr<void> m_texture_owner{nullptr};
 
  public:
   Image() noexcept = default;
@@ -21,6 +25,11 @@ class Image {
   Image(const std::shared_ptr<NVGcontext>& context,
         ImageHandle handle) noexcept;
 
+  /// Constructs an image from a region of a shared texture, in pixels. The
+  /// texture is kept alive by the owner rather than deleted by the image.
+  Image(const std::shared_ptr<NVGcontext>& context, ImageHandle handle,
+        const Rect& region, std::shared_ptr<void> texture_owner) noexcept;
+
   Image(Image&& image) noexcept;
 
   ~Image() noexcept;
@@ -29,8 +38,28 @@ class Image {
 
   std::optional<ImageHandle> getHandle() const noexcept;
 
+  /// Returns the size of the image, which is the size of its region for
+  /// images in a shared texture.
   std::pair<int, int> getSize() const noexcept;
 
+  /// Returns the size of the whole texture the image is in.
+  std::pair<int, int> getTextureSize() const noexcept;
+
+  /// Returns the number of channels of the texture the image is in, one for
+  /// alpha textures and four for RGBA ones, or zero if none is loaded.
+  int getChannelCount() const noexcept;
+
+  /// Returns the flags the texture the image is in was created with.
+  /// Textures created with mip levels have IMAGE_GENERATE_MIPMAPS set.
+  int getImageFlags() const noexcept;
+
+  /// Returns the part of the texture the image covers, in pixels.
+  Rect getRegion() const noexcept;
+
+  /// Returns true if the image is a region of a texture shared with other
+  /// images.
+  bool isSharedTexture() const noexcept;
+
  protected:
   Image(const Image&) = delete;
 
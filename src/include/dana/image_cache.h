@@ -0,0 +1,118 @@
+#pragma once
+
+#include "dana/image.h"
+#include "dana/pencil.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace dana {
+
+class ImageCache;
+
+/// A shared handle to an image in an ImageCache. The texture of the image may
+/// be evicted while it is not drawn, and is loaded again when it is needed.
+/// The cache has to outlive its handles.
+class CachedImage {
+  friend class ImageCache;
+
+  struct Entry {
+    std::function<Image(Pencil&)> load;
+    Image image;
+    std::size_t bytes{0};
+    bool resident{false};
+    uint64_t last_use_frame{0};
+    std::list<Entry*>::iterator lru_position;
+  };
+
+  ImageCache* m_cache{nullptr};
+  std::shared_ptr<Entry> m_entry{nullptr};
+
+ public:
+  CachedImage() noexcept = default;
+
+  /// Returns the image for drawing, loading it again if it was evicted, and
+  /// marks it as recently drawn.
+  const Image& get() const noexcept;
+
+  /// Returns true if the texture of the image is currently loaded.
+  bool isResident() const noexcept;
+};
+
+/// Shares images by key, and bounds the memory their textures take. When
+/// loading an image brings the total over the budget, the least recently
+/// drawn textures are deleted until it fits again. Their handles stay valid
+/// and load the image again when drawn. Images drawn in the current frame are
+/// never evicted, so the total can exceed the budget for a frame that draws
+/// more than fits.
+///
+/// Texture memory is estimated from the size, the number of channels and the
+/// mip levels of the loaded textures.
+class ImageCache {
+  friend class CachedImage;
+
+  using Entry = CachedImage::Entry;
+
+  Pencil& m_pencil;
+  std::size_t m_budget;
+  std::size_t m_resident_bytes{0};
+  std::unordered_map<std::string, std::shared_ptr<Entry>> m_entries;
+  std::list<Entry*> m_lru;
+
+  uint64_t m_hits{0};
+  uint64_t m_misses{0};
+  uint64_t m_evictions{0};
+
+ public:
+  static constexpr std::size_t default_budget{256 * 1024 * 1024};
+
+  /// Constructs a cache that loads images with a given pencil, and keeps
+  /// their textures within a budget in bytes.
+  explicit ImageCache(Pencil& pencil,
+                      std::size_t budget = default_budget) noexcept;
+
+  /// Returns the image of a file, loading it if it is not cached.
+  CachedImage get(const std::string& filename, int image_flags) noexcept;
+
+  /// Returns the image with a given key, such as a content hash, which is
+  /// loaded by a given function if it is not cached. The function is kept to
+  /// load the image again after it has been evicted.
+  CachedImage get(const std::string& key,
+                  std::function<Image(Pencil&)> load) noexcept;
+
+  ImageCache& setBudget(std::size_t budget) noexcept;
+
+  std::size_t getBudget() const noexcept;
+
+  /// Returns the estimated memory of all loaded textures in bytes.
+  std::size_t getResidentBytes() const noexcept;
+
+  /// Returns the number of cached images, loaded or not.
+  std::size_t getImageCount() const noexcept;
+
+  /// Returns the number of times a loaded image was used.
+  uint64_t getHitCount() const noexcept;
+
+  /// Returns the number of times an image had to be loaded, either for the
+  /// first time or after it was evicted.
+  uint64_t getMissCount() const noexcept;
+
+  /// Returns the number of textures deleted to stay within the budget.
+  uint64_t getEvictionCount() const noexcept;
+
+ protected:
+  ImageCache(const ImageCache&) = delete;
+
+  ImageCache& operator=(const ImageCache&) = delete;
+
+ private:
+  const Image& use(Entry& entry) noexcept;
+
+  void evict() noexcept;
+};
+}  // namespace dana
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "dana/types.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace dana {
+
+/// RGBA pixels in memory that are edited on the CPU and put into an image with
+/// Pencil::putImageData(). The rectangles changed since the previous upload
+/// are tracked, so only those are uploaded, and a frame costs bandwidth in
+/// proportion to what changed.
+///
+/// Changes made through the setters are tracked automatically. Pixels written
+/// through getPixels() have to be marked dirty by hand.
+class ImageData {
+  int m_width;
+  int m_height;
+  std::vector<unsigned char> m_pixels;
+  std::vector<Rect> m_dirty_rects;
+
+ public:
+  /// Dirty rectangles are merged into their bounding box beyond this count,
+  /// so an upload takes a bounded number of calls.
+  static constexpr std::size_t max_dirty_rects{8};
+
+  /// Constructs transparent black pixels of a given size. All pixels start
+  /// out dirty.
+  ImageData(int width, int height);
+
+  ImageData(ImageData&& image_data) noexcept = default;
+
+  ImageData& operator=(ImageData&& image_data) noexcept = default;
+
+  std::pair<int, int> getSize() const noexcept;
+
+  /// Returns the pixels, row by row from the top, four bytes per pixel.
+  unsigned char* getPixels() noexcept;
+
+  const unsigned char* getPixels() const noexcept;
+
+  Color getPixel(int x, int y) const noexcept;
+
+  ImageData& setPixel(int x, int y, const Color& color) noexcept;
+
+  /// Fills a rectangle with a color.
+  ImageData& fill(const Rect& rect, const Color& color) noexcept;
+
+  /// Copies a block of RGBA pixels to a position, clipped to the image. The
+  /// stride is the number of pixels between the starts of two rows.
+  ImageData& putPixels(int x, int y, int width, int height, int stride,
+                       const unsigned char* pixels) noexcept;
+
+  /// Marks a rectangle as changed. The rectangle is clipped to the image and
+  /// rounded out to whole pixels, and merged with the dirty rectangles it
+  /// touches.
+  ImageData& markDirty(const Rect& rect) noexcept;
+
+  ImageData& markAllDirty() noexcept;
+
+  /// Marks all pixels as uploaded.
+  ImageData& clearDirty() noexcept;
+
+  bool isDirty() const noexcept;
+
+  /// Returns the rectangles changed since the previous upload, which do not
+  /// overlap or touch each other.
+  const std::vector<Rect>& getDirtyRects() const noexcept;
+
+  /// Returns the number of bytes the next upload transfers.
+  std::size_t getDirtyBytes() const noexcept;
+
+ protected:
+  ImageData(const ImageData&) = delete;
+
+  ImageData& operator=(const ImageData&) = delete;
+};
+}  // namespace dana
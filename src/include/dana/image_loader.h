@@ -0,0 +1,127 @@
+#pragma once
+
+#include "dana/image.h"
+#include "dana/pencil.h"
+#include "dana/thread_pool.h"
+#include "dana/types.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dana {
+
+enum class ImageStatus { LOADING, READY, FAILED };
+
+/// How an image is prepared while it is decoded.
+struct ImageLoadOptions {
+  /// Downsizes images wider than this, keeping the aspect ratio. Zero keeps
+  /// the width.
+  int max_width{0};
+
+  /// Downsizes images higher than this, keeping the aspect ratio. Zero keeps
+  /// the height.
+  int max_height{0};
+
+  /// Multiplies the colors by alpha, and marks the image as premultiplied.
+  bool premultiply{false};
+};
+
+/// A handle to an image that is being loaded by an ImageLoader. Until the
+/// image is ready, the handle gives a placeholder image, so it can be drawn
+/// right away. Copies of a handle refer to the same image.
+class AsyncImage {
+  friend class ImageLoader;
+
+  struct State {
+    std::atomic<ImageStatus> status{ImageStatus::LOADING};
+    Image image;
+    std::shared_ptr<const Image> placeholder;
+  };
+
+  std::shared_ptr<State> m_state{nullptr};
+
+ public:
+  AsyncImage() noexcept = default;
+
+  ImageStatus getStatus() const noexcept;
+
+  bool isReady() const noexcept;
+
+  /// Returns the image once it is ready, and the placeholder until then or if
+  /// loading failed.
+  const Image& getImage() const noexcept;
+};
+
+/// Decodes images on a thread pool and uploads them to textures on the
+/// rendering thread, so loading large images does not stall frames.
+///
+/// Decoded images are uploaded by upload(), which canvases call at the start
+/// of every frame. Each call uploads images until a time budget is used up,
+/// but at least one, so a burst of finished images is spread over several
+/// frames. Files are decoded in parallel, one task per file, so loading many
+/// files at once uses all workers of the pool.
+class ImageLoader {
+  struct Decoded {
+    std::shared_ptr<AsyncImage::State> state;
+    std::vector<unsigned char> pixels;
+    int width;
+    int height;
+    int image_flags;
+  };
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Decoded> decoded;
+    std::atomic<bool> cancelled{false};
+    std::function<void()> notify;
+  };
+
+  Pencil& m_pencil;
+  ThreadPool& m_thread_pool;
+  std::shared_ptr<Queue> m_queue;
+  std::shared_ptr<const Image> m_placeholder{nullptr};
+  std::chrono::microseconds m_upload_budget{default_upload_budget};
+
+ public:
+  static constexpr std::chrono::microseconds default_upload_budget{4000};
+
+  /// Constructs a loader that decodes on a given pool and uploads with a
+  /// given pencil. The notification is called from worker threads whenever an
+  /// image has been decoded and waits for upload().
+  ImageLoader(Pencil& pencil, ThreadPool& thread_pool,
+              std::function<void()> notify = {});
+
+  /// Stops decoding images that have not been started yet.
+  ~ImageLoader() noexcept;
+
+  /// Starts loading an image from file, and returns a handle to it.
+  AsyncImage createImageAsync(const std::string& filename, int image_flags,
+                              const ImageLoadOptions& options = {});
+
+  /// Sets the color of the placeholder for images created after this call.
+  ImageLoader& setPlaceholderColor(const Color& color) noexcept;
+
+  /// Sets how long upload() may spend uploading images per call.
+  ImageLoader& setUploadBudget(std::chrono::microseconds budget) noexcept;
+
+  /// Returns true if decoded images are waiting to be uploaded.
+  bool hasPendingUploads() const noexcept;
+
+  /// Uploads decoded images until the budget is used up, and returns the
+  /// number of images that became ready. Has to be called on the rendering
+  /// thread.
+  std::size_t upload() noexcept;
+
+ protected:
+  ImageLoader(const ImageLoader&) = delete;
+
+  ImageLoader& operator=(const ImageLoader&) = delete;
+};
+}  // namespace dana
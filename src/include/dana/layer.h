@@ -0,0 +1,96 @@
+#pragma once
+
+#include "dana/framebuffer.h"
+#include "dana/framebuffer_pool.h"
+#include "dana/image.h"
+#include "dana/pencil.h"
+#include "dana/types.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace dana {
+
+/// The callback type used to draw graphics onto a canvas or layer.
+using DrawCallback = std::function<void(Pencil&)>;
+
+/// Graphics that are drawn once into an offscreen texture and composited onto
+/// a canvas every frame. The draw callback only runs again when the layer is
+/// invalidated or resized, which makes layers a good fit for static content
+/// such as backgrounds, grids and legends. Layers are created with
+/// Canvas::createLayer().
+class Layer {
+  friend class Canvas;
+
+  int m_width{0};
+  int m_height{0};
+  DrawCallback m_draw_callback{[](Pencil&) {}};
+  TransformMatrix m_transform{1, 0, 0, 1, 0, 0};
+  unsigned char m_opacity{255};
+  int m_z_order{0};
+  bool m_visible{true};
+  bool m_invalidated{true};
+  uint64_t m_render_count{0};
+
+  std::unique_ptr<Framebuffer> m_framebuffer{nullptr};
+  Image m_image;
+  std::function<void()> m_changed_callback{nullptr};
+
+ public:
+  /// Constructs a layer of a given size in window coordinates.
+  Layer(int width, int height) noexcept;
+
+  /// Sets the callback that draws the content of the layer, and invalidates
+  /// the layer.
+  Layer& onDraw(const DrawCallback& draw_callback) noexcept;
+
+  /// Resizes the layer, which invalidates it.
+  Layer& setSize(int width, int height) noexcept;
+
+  std::pair<int, int> getSize() const noexcept;
+
+  /// Sets the transform the layer is composited with.
+  Layer& setTransform(const TransformMatrix& transform) noexcept;
+
+  const TransformMatrix& getTransform() const noexcept;
+
+  /// Sets the opacity the layer is composited with.
+  Layer& setOpacity(unsigned char opacity) noexcept;
+
+  unsigned char getOpacity() const noexcept;
+
+  /// Sets the stacking order of the layer. Layers with a higher z-order are
+  /// composited on top. Layers with a negative z-order are composited below
+  /// the graphics of the canvas draw callback, all others above.
+  Layer& setZOrder(int z_order) noexcept;
+
+  int getZOrder() const noexcept;
+
+  /// Shows or hides the layer. A hidden layer keeps its texture.
+  Layer& setVisible(bool visible) noexcept;
+
+  bool isVisible() const noexcept;
+
+  /// Makes the draw callback run again before the layer is composited next.
+  void invalidate() noexcept;
+
+  /// Returns the number of times the draw callback has run.
+  uint64_t getRenderCount() const noexcept;
+
+ protected:
+  Layer(const Layer&) = delete;
+
+  Layer& operator=(const Layer&) = delete;
+
+ private:
+  bool render(Pencil& pencil, FramebufferPool& pool, float pixel_ratio);
+
+  void composite(Pencil& pencil) const noexcept;
+
+  void release(FramebufferPool& pool) noexcept;
+
+  void notifyChanged() const noexcept;
+};
+}  // namespace dana
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "dana/types.h"
+#include "dana/util.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct NVGcontext;
+struct NVGgeometry;
+
+namespace dana {
+
+/// A path that is built once and drawn many times with Pencil::fill() and
+/// Pencil::stroke(). Unlike a path built with the pencil, the flattened and
+/// tessellated geometry of the path is kept across frames, one version for
+/// each stroke style and scale it is drawn with. As long as the transform only
+/// translates, rotates and scales uniformly, drawing the path reuses the
+/// cached geometry, and only has to transform its vertices.
+///
+/// Scales are grouped into buckets of a quarter octave, so zooming does not
+/// tessellate the path again on every frame. Paths drawn with skewing or
+/// non-uniform scaling are tessellated every time.
+///
+/// Copies of a path share the cached geometry until either one is changed.
+class Path {
+  friend class Pencil;
+
+  enum class Verbs {
+    MOVE_TO,
+    LINE_TO,
+    BEZIER_TO,
+    QUAD_TO,
+    ARC_TO,
+    CLOSE_PATH,
+    FILL_RULE,
+    ARC,
+    RECTANGLE,
+    ROUNDED_RECTANGLE,
+    ELLIPSE,
+    CIRCLE
+  };
+
+  struct Command {
+    Verbs verb;
+    std::array<float, 8> values;
+  };
+
+  struct GeometryKey {
+    bool stroke;
+    int scale_bucket;
+    float pixel_ratio;
+    bool anti_alias;
+    float stroke_width;
+    float miter_limit;
+    int line_cap;
+    int line_join;
+
+    bool operator==(const GeometryKey& other) const noexcept;
+  };
+
+  struct CachedGeometry {
+    GeometryKey key;
+    c_unique_ptr<NVGgeometry> geometry;
+    uint64_t last_use;
+  };
+
+  struct GeometryCache {
+    std::vector<CachedGeometry> entries;
+    uint64_t use_count{0};
+    uint64_t tessellation_count{0};
+  };
+
+  std::vector<Command> m_commands;
+  mutable std::shared_ptr<GeometryCache> m_cache{nullptr};
+
+ public:
+  /// The number of geometry versions kept per path. The least recently drawn
+  /// version is dropped when another one is needed.
+  static constexpr std::size_t max_cached_geometries{8};
+
+  /// Moves to a given position, starting a new sub-path.
+  Path& moveTo(float x, float y) noexcept;
+
+  /// Adds a line to a given position.
+  Path& lineTo(float x, float y) noexcept;
+
+  /// Adds a bezier to a given position with two given control points.
+  Path& bezierTo(float c1x, float c1y, float c2x, float c2y, float x,
+                 float y) noexcept;
+
+  /// Adds a quadratic bezier curve to a given position with one given control
+  /// point.
+  Path& quadTo(float cx, float cy, float x, float y) noexcept;
+
+  /// Adds an arc between two tangents.
+  Path& arcTo(float x1, float y1, float x2, float y2, float radius) noexcept;
+
+  /// Closes the current sub-path.
+  Path& closePath() noexcept;
+
+  /// Sets the fill rule of the current sub-path.
+  Path& setPathFillRule(Solidity solidity) noexcept;
+
+  /// Adds an arc that can become a full circle, or just part of a circle.
+  Path& arc(float center_x, float center_y, float radius, float start_angle,
+            float end_angle, Direction direction) noexcept;
+
+  /// Adds a rectangle.
+  Path& rectangle(float x, float y, float width, float height) noexcept;
+
+  /// Adds a rounded rectangle with one given roundness radius for all corners.
+  Path& roundedRectangle(float x, float y, float width, float height,
+                         float radius) noexcept;
+
+  /// Adds a rounded rectangle with a given roundness radius for each corner.
+  Path& roundedRectangle(float x, float y, float width, float height,
+                         float radius_top_left, float radius_top_right,
+                         float radius_bottom_right,
+                         float radius_bottom_left) noexcept;
+
+  /// Adds an ellipse.
+  Path& ellipse(float center_x, float center_y, float radius_x,
+                float radius_y) noexcept;
+
+  /// Adds a circle.
+  Path& circle(float center_x, float center_y, float radius) noexcept;
+
+  /// Removes all sub-paths.
+  Path& clear() noexcept;
+
+  bool isEmpty() const noexcept;
+
+  /// Returns the number of geometry versions currently cached.
+  std::size_t getCachedGeometryCount() const noexcept;
+
+  /// Returns the number of times the path has been tessellated into cached
+  /// geometry since it was last changed.
+  uint64_t getTessellationCount() const noexcept;
+
+ private:
+  Path& append(Verbs verb, std::array<float, 8> values) noexcept;
+
+  void build(NVGcontext* context) const noexcept;
+
+  void draw(NVGcontext* context, bool stroke) const noexcept;
+
+  void drawInstances(NVGcontext* context,
+                     Span<const TransformMatrix> transforms,
+                     Span<const Color> colors) const noexcept;
+
+  NVGgeometry* getGeometry(NVGcontext* context, bool stroke, float scale,
+                           float& bucket_scale) const noexcept;
+
+  NVGgeometry* findGeometry(const GeometryKey& key) const noexcept;
+
+  NVGgeometry* tessellate(NVGcontext* context, const GeometryKey& key,
+                          float scale) const noexcept;
+};
+}  // namespace dana
@@ -1,8 +1,17 @@
 #pragma once
 
+#include "dana/asset_pack.h"
+#include "dana/framebuffer.h"
 #include "dana/image.h"
+#include "dana/image_data.h"
+#include "dana/path.h"
+#include "dana/sprite_batch.h"
+#include "dana/texture_atlas.h"
 #include "dana/types.h"
+#include "dana/util.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -10,8 +19,50 @@ struct NVGcontext;
 
 namespace dana {
 
+/// \brief Counters of the work done by the renderer of a pencil.
+struct RenderStatistics {
+  /// \brief Number of flushes that drew anything.
+  uint64_t flushes{0};
+
+  /// \brief Number of times writing to a streaming buffer restarted at its
+  /// start.
+  uint64_t stream_wraps{0};
+
+  /// \brief Number of times the CPU had to wait for the GPU to finish reading
+  /// a part of a streaming buffer before overwriting it.
+  uint64_t stream_stalls{0};
+
+  /// \brief Number of times a streaming buffer was given new storage, because
+  /// it had to grow or wrapped without fences to wait on.
+  uint64_t stream_orphans{0};
+
+  /// \brief Number of fill, stroke and text calls submitted to the renderer.
+  uint64_t calls{0};
+
+  /// \brief Number of submitted calls drawn together with the calls before
+  /// them, because they share their paint, image and composite operation.
+  uint64_t merged_calls{0};
+
+  /// \brief Number of draw commands issued to OpenGL.
+  uint64_t draw_calls{0};
+
+  /// \brief Number of instanced draws done with instancing on the GPU, rather
+  /// than by drawing each instance separately.
+  uint64_t instanced_calls{0};
+
+  /// \brief Number of changes of call type, image or composite operation
+  /// between consecutive calls, in the order they were submitted in.
+  uint64_t submitted_state_changes{0};
+
+  /// \brief Number of such changes in the order the calls were drawn in, which
+  /// is lower when draw call reordering groups calls.
+  uint64_t state_changes{0};
+};
+
 class Pencil {
   std::shared_ptr<NVGcontext> m_context{nullptr};
+  TextureAtlas* m_texture_atlas{nullptr};
+  uint64_t m_frame_count{0};
 
  public:
   explicit Pencil();
@@ -21,6 +72,28 @@ class Pencil {
   /// as frameBufferWidth / windowWidth.
   Pencil& beginFrame(float width, float height, float pixel_ratio) noexcept;
 
+  /// \brief Returns the number of frames begun with this pencil, including
+  /// the current one.
+  uint64_t getFrameCount() const noexcept;
+
+  /// \brief Sets the capacity of each buffer vertices, uniforms and instances
+  /// are streamed to the GPU through, in bytes. Each flush writes to the next
+  /// free part of the buffers, and only waits for the GPU when it wraps onto a
+  /// part still in use. Buffers grow when a single flush does not fit.
+  Pencil& setStreamBufferSize(std::size_t size) noexcept;
+
+  /// \brief Sets whether calls that do not overlap may be drawn out of order
+  /// when the frame ends, grouped by type, image and composite operation, so
+  /// the renderer changes state less often. Calls that overlap keep their
+  /// order, so the frame looks the same. Disabled by default.
+  Pencil& setDrawCallReordering(bool enabled) noexcept;
+
+  /// \brief Returns the counters of the renderer since they were last reset.
+  RenderStatistics getRenderStatistics() const noexcept;
+
+  /// \brief Resets the counters of the renderer.
+  Pencil& resetRenderStatistics() noexcept;
+
   /// \brief Cancels drawing the current frame.
   Pencil& cancelFrame() noexcept;
 
@@ -143,6 +216,15 @@ class Pencil {
   /// \brief Resets and disables scissoring.
   Pencil& resetScissor() noexcept;
 
+  /// \brief Restricts rendering to a rectangle of the framebuffer in pixels,
+  /// with the origin in the bottom-left corner. Unlike scissor(), the clip
+  /// rectangle is applied by the GPU, ignores transforms and is kept across
+  /// frames until reset.
+  Pencil& setClipRect(int x, int y, int width, int height) noexcept;
+
+  /// \brief Removes the clip rectangle.
+  Pencil& resetClipRect() noexcept;
+
   /// \brief Begins a new path by clearing the current path.
   Pencil& beginPath() noexcept;
 
@@ -197,23 +279,101 @@ class Pencil {
   /// \brief Creates a circle shape.
   Pencil& circle(float center_x, float center_y, float radius) noexcept;
 
+  /// \brief Creates one rectangle shape for each given rectangle, in a single
+  /// call.
+  Pencil& rectangles(Span<const Rect> rects) noexcept;
+
+  /// \brief Creates one circle shape for each given circle, in a single call.
+  Pencil& circles(Span<const Circle> circles) noexcept;
+
+  /// \brief Creates one line for each four given values, which are the start
+  /// and end positions of the line.
+  Pencil& lineSegments(Span<const float> points) noexcept;
+
   /// \brief Fills the current path with the current fill style.
   Pencil& fill() noexcept;
 
   /// \brief Strokes the current path with the current stroke style.
   Pencil& stroke() noexcept;
 
-  /// \brief Creates an image from file.
+  /// \brief Fills a retained path with the current fill style, reusing its
+  /// cached geometry when possible. Replaces the current path.
+  Pencil& fill(const Path& path) noexcept;
+
+  /// \brief Strokes a retained path with the current stroke style, reusing its
+  /// cached geometry when possible. Replaces the current path.
+  Pencil& stroke(const Path& path) noexcept;
+
+  /// \brief Fills a retained path once for every given transform, each applied
+  /// before the current transform. The fill style is multiplied by one color
+  /// per instance, by a single color shared by all, or by none. Nothing is
+  /// drawn for any other number of colors. Convex shapes are drawn with a
+  /// single instanced draw call where supported.
+  Pencil& drawInstances(const Path& shape,
+                        Span<const TransformMatrix> transforms,
+                        Span<const Color> colors = {}) noexcept;
+
+  /// \brief Draws all sprites of a batch with the current transform, composite
+  /// operation, scissor and global alpha.
+  Pencil& drawSprites(const SpriteBatch& batch) noexcept;
+
+  /// \brief Creates an image from file. The image is placed in the texture
+  /// atlas if one is set, the image fits and its flags match those of the
+  /// atlas.
   Image createImage(const std::string& filename, int image_flags) const
       noexcept;
 
-  /// \brief Creates an image from a memory buffer.
+  /// \brief Creates an image from a memory buffer. The image is placed in the
+  /// texture atlas if one is set, the image fits and its flags match those of
+  /// the atlas.
   Image createImage(unsigned char* data, int size, int image_flags) const
       noexcept;
 
+  /// \brief Creates an image from RGBA pixels. The image is placed in the
+  /// texture atlas if one is set, the image fits and its flags match those of
+  /// the atlas.
+  Image createImage(int width, int height, const unsigned char* pixels,
+                    int image_flags) const noexcept;
+
+  /// \brief Creates an image from pixels in memory, and marks them as
+  /// uploaded. The image is placed in the texture atlas if one is set, the
+  /// image fits and its flags match those of the atlas.
+  Image createImage(ImageData& image_data, int image_flags) const noexcept;
+
+  /// \brief Uploads the changed pixels of image data to an image of the same
+  /// size, one dirty rectangle at a time, and marks them as uploaded. The
+  /// upload happens right away, so it shows in everything drawn in the current
+  /// frame. Mipmaps are not updated.
+  Pencil& putImageData(const Image& image, ImageData& image_data) noexcept;
+
+  /// \brief Creates an image from an asset pack, uploading its pixels and mip
+  /// levels straight from the pack. The image flags are added to those the
+  /// image was packed with. Returns an empty image if the pack has no image
+  /// with the given name. Packed images are not placed in the texture atlas.
+  Image createImage(const AssetPack& pack, const std::string& name,
+                    int image_flags = 0) const noexcept;
+
+  /// \brief Creates an image that shows the color buffer of a framebuffer
+  /// without copying it. The framebuffer has to outlive the image.
+  Image createImage(const Framebuffer& framebuffer) const noexcept;
+
+  /// \brief Creates a pattern that shows an image. Images in a shared texture
+  /// are mapped to their region of the texture, and do not repeat.
   Paint createImagePattern(const Image& image, float top_left_x,
                            float top_left_y, float image_width,
                            float image_height, float angle,
                            unsigned char alpha) const noexcept;
+
+  /// \brief Creates a texture atlas for packing many small images into a few
+  /// textures.
+  TextureAtlas createTextureAtlas(
+      int page_size = TextureAtlas::default_page_size,
+      int padding = TextureAtlas::default_padding,
+      int image_flags = 0) const noexcept;
+
+  /// \brief Sets the texture atlas small images created from files or memory
+  /// are placed in, or none. The atlas has to outlive the pencil, or be unset
+  /// before it is destroyed.
+  Pencil& setTextureAtlas(TextureAtlas* atlas) noexcept;
 };
 }  // namespace dana
@@ -0,0 +1,223 @@
+#pragma once
+
+#include "dana/path.h"
+#include "dana/pencil.h"
+#include "dana/types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace dana {
+
+/// Records drawing calls, with the same API as Pencil, so they can be replayed
+/// into a pencil any number of times. Recording does not need a pencil or an
+/// OpenGL context, so pictures can be built ahead of time or on other threads.
+///
+/// Calls are stored as plain records in a single contiguous buffer. Clearing a
+/// picture keeps the buffer, so recording the same content again every frame
+/// does not allocate.
+class Picture {
+  enum class Opcodes : uint8_t {
+    SET_GLOBAL_COMPOSITE_OPERATION,
+    SET_GLOBAL_COMPOSITE_BLEND_FUNC_SEPARATE,
+    SAVE,
+    RESTORE,
+    RESET,
+    SET_ANTI_ALIAS,
+    SET_STROKE_COLOR,
+    SET_STROKE_PAINT,
+    SET_FILL_COLOR,
+    SET_FILL_PAINT,
+    SET_MITER_LIMIT,
+    SET_STROKE_WIDTH,
+    SET_LINE_CAP,
+    SET_LINE_JOIN,
+    SET_GLOBAL_ALPHA,
+    RESET_TRANSFORM,
+    TRANSFORM,
+    TRANSLATE,
+    ROTATE,
+    SKEW_X,
+    SKEW_Y,
+    SCALE,
+    SCISSOR,
+    INTERSECT_SCISSOR,
+    RESET_SCISSOR,
+    BEGIN_PATH,
+    MOVE_TO,
+    LINE_TO,
+    BEZIER_TO,
+    QUAD_TO,
+    ARC_TO,
+    CLOSE_PATH,
+    SET_PATH_FILL_RULE,
+    ARC,
+    RECTANGLE,
+    ROUNDED_RECTANGLE,
+    ELLIPSE,
+    CIRCLE,
+    FILL,
+    STROKE,
+    FILL_PATH,
+    STROKE_PATH
+  };
+
+  std::vector<unsigned char> m_buffer;
+  std::size_t m_command_count{0};
+
+ public:
+  /// Removes all recorded calls, but keeps the memory of the buffer.
+  Picture& clear() noexcept;
+
+  bool isEmpty() const noexcept;
+
+  /// Returns the number of recorded calls.
+  std::size_t getCommandCount() const noexcept;
+
+  /// Returns the size of the recorded calls in bytes.
+  std::size_t getSize() const noexcept;
+
+  /// Reserves buffer memory for recording a given number of bytes.
+  Picture& reserve(std::size_t size) noexcept;
+
+  /// Replays all recorded calls into a pencil, in the order they were
+  /// recorded.
+  void replay(Pencil& pencil) const noexcept;
+
+  Picture& setGlobalCompositeOperation(
+      CompositeOperations composite_operation) noexcept;
+
+  Picture& setGlobalCompositeBlendFunc(BlendFactors src_factor,
+                                       BlendFactors dst_factor) noexcept;
+
+  Picture& setGlobalCompositeBlendFuncSeparate(
+      BlendFactors src_rgb, BlendFactors dst_rgb, BlendFactors src_alpha,
+      BlendFactors dst_alpha) noexcept;
+
+  Picture& save() noexcept;
+
+  Picture& restore() noexcept;
+
+  Picture& reset() noexcept;
+
+  Picture& setAntiAlias(bool enabled) noexcept;
+
+  Picture& setStrokeColor(const Color& color) noexcept;
+
+  Picture& setStrokePaint(const Paint& paint) noexcept;
+
+  Picture& setFillColor(const Color& color) noexcept;
+
+  Picture& setFillPaint(const Paint& paint) noexcept;
+
+  Picture& setMiterLimit(float limit) noexcept;
+
+  Picture& setStrokeWidth(float size) noexcept;
+
+  Picture& setLineCap(LineCap cap) noexcept;
+
+  Picture& setLineJoin(LineJoin join) noexcept;
+
+  Picture& setGlobalAlpha(unsigned char alpha) noexcept;
+
+  Picture& resetTransform() noexcept;
+
+  Picture& transform(float horizontal_scaling, float horizontal_skewing,
+                     float vertical_skewing, float vertical_scaling,
+                     float horizontal_moving, float vertical_moving) noexcept;
+
+  Picture& transform(const TransformMatrix& matrix) noexcept;
+
+  Picture& translate(float x, float y) noexcept;
+
+  Picture& rotate(float angle) noexcept;
+
+  Picture& skewX(float angle) noexcept;
+
+  Picture& skewY(float angle) noexcept;
+
+  Picture& scale(float x_percent, float y_percent) noexcept;
+
+  Picture& scissor(float x, float y, float width, float height) noexcept;
+
+  Picture& intersectScissor(float x, float y, float width,
+                            float height) noexcept;
+
+  Picture& resetScissor() noexcept;
+
+  Picture& beginPath() noexcept;
+
+  Picture& moveTo(float x, float y) noexcept;
+
+  Picture& lineTo(float x, float y) noexcept;
+
+  Picture& bezierTo(float c1x, float c1y, float c2x, float c2y, float x,
+                    float y) noexcept;
+
+  Picture& quadTo(float cx, float cy, float x, float y) noexcept;
+
+  Picture& arcTo(float x1, float y1, float x2, float y2,
+                 float radius) noexcept;
+
+  Picture& closePath() noexcept;
+
+  Picture& setPathFillRule(Solidity solidity) noexcept;
+
+  Picture& arc(float center_x, float center_y, float radius,
+               float start_angle, float end_angle,
+               Direction direction) noexcept;
+
+  Picture& rectangle(float x, float y, float width, float height) noexcept;
+
+  Picture& roundedRectangle(float x, float y, float width, float height,
+                            float radius) noexcept;
+
+  Picture& roundedRectangle(float x, float y, float width, float height,
+                            float radius_top_left, float radius_top_right,
+                            float radius_bottom_right,
+                            float radius_bottom_left) noexcept;
+
+  Picture& ellipse(float center_x, float center_y, float radius_x,
+                   float radius_y) noexcept;
+
+  Picture& circle(float center_x, float center_y, float radius) noexcept;
+
+  Picture& fill() noexcept;
+
+  Picture& stroke() noexcept;
+
+  /// Records filling a retained path. Only a reference to the path is
+  /// recorded, so the path has to outlive the picture and must not be changed
+  /// while the picture is replayed.
+  Picture& fill(const Path& path) noexcept;
+
+  /// Records stroking a retained path. Only a reference to the path is
+  /// recorded, so the path has to outlive the picture and must not be changed
+  /// while the picture is replayed.
+  Picture& stroke(const Path& path) noexcept;
+
+ private:
+  template <typename... Args>
+  Picture& record(Opcodes opcode, const Args&... args) noexcept;
+};
+
+template <typename... Args>
+Picture& Picture::record(const Opcodes opcode, const Args&... args) noexcept {
+  static_assert((std::is_trivially_copyable_v<Args> && ...),
+                "Recorded arguments have to be trivially copyable");
+
+  auto offset{m_buffer.size()};
+  m_buffer.resize(offset + sizeof(opcode) + (sizeof(Args) + ... + 0));
+
+  std::memcpy(m_buffer.data() + offset, &opcode, sizeof(opcode));
+  offset += sizeof(opcode);
+  ((std::memcpy(m_buffer.data() + offset, &args, sizeof(Args)),
+    offset += sizeof(Args)),
+   ...);
+  ++m_command_count;
+  return *this;
+}
+}  // namespace dana
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace dana {
+
+/// A view of the RGBA pixels read back from a rendered frame. Rows are stored
+/// bottom to top, as OpenGL reads them. The data points into a mapped pixel
+/// buffer and is only valid during the callback it is passed to.
+struct FramePixels {
+  uint64_t frame{0};
+  int width{0};
+  int height{0};
+  int stride{0};
+  const unsigned char* data{nullptr};
+};
+
+/// The callback type used to receive pixels read back from rendered frames.
+using ReadbackCallback = std::function<void(const FramePixels&)>;
+
+class Readback {
+  struct Slot;
+
+  std::vector<Slot> m_slots;
+  std::size_t m_oldest{0};
+  std::size_t m_pending{0};
+  bool m_fences_supported{false};
+  ReadbackCallback m_callback;
+
+ public:
+  /// Constructs a readback ring of a given number of pixel buffers. Pixels of a
+  /// frame are handed to the callback once the GPU has written them, at most
+  /// buffer_count - 1 frames later. Requires a current OpenGL context.
+  Readback(std::size_t buffer_count, const ReadbackCallback& callback);
+
+  ~Readback() noexcept;
+
+  /// Queues an asynchronous read of a region of the current read framebuffer.
+  /// If all buffers are in flight, this waits for the oldest one first.
+  void queue(int x, int y, int width, int height, uint64_t frame) noexcept;
+
+  /// Hands every finished read to the callback without blocking.
+  void poll() noexcept;
+
+  /// Waits for all queued reads and hands them to the callback.
+  void flush() noexcept;
+
+  /// Returns the number of reads that have not been handed to the callback.
+  std::size_t getPending() const noexcept;
+
+ protected:
+  Readback(const Readback&) = delete;
+
+  Readback& operator=(const Readback&) = delete;
+
+ private:
+  bool deliverOldest(bool wait) noexcept;
+};
+}  // namespace dana
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "dana/events.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+namespace dana {
+
+/// Controls when a canvas renders new frames. Continuous canvases render every
+/// frame the scheduler allows, while on-demand canvases sleep until they are
+/// invalidated, receive input or window events, or their redraw interval
+/// elapses.
+enum class RedrawModes { CONTINUOUS, ON_DEMAND };
+
+/// Decides when a canvas renders a frame and how long its event loop may
+/// sleep, from the redraw mode, the visibility of the window, invalidation and
+/// the redraw interval. Nothing is rendered while the window is hidden.
+class RedrawScheduler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+ private:
+  RedrawModes m_redraw_mode{RedrawModes::CONTINUOUS};
+  std::atomic<bool> m_invalidated{true};
+  bool m_visible{true};
+  Clock::duration m_redraw_interval{0};
+  Clock::time_point m_last_frame_time{};
+  std::function<void()> m_wake_up{nullptr};
+
+ public:
+  /// Constructs a scheduler that calls a callback to wake up the event loop
+  /// when it is invalidated.
+  explicit RedrawScheduler(std::function<void()> wake_up = nullptr) noexcept;
+
+  void setRedrawMode(RedrawModes redraw_mode) noexcept;
+
+  RedrawModes getRedrawMode() const noexcept;
+
+  /// Sets the longest time an on-demand canvas waits before redrawing. An
+  /// interval of zero disables the timer.
+  void setRedrawInterval(Clock::duration redraw_interval) noexcept;
+
+  /// Requests a frame and wakes up the event loop. Can be called from any
+  /// thread.
+  void invalidate() noexcept;
+
+  /// Requests a frame without waking up the event loop, for events the loop
+  /// is handling already.
+  void handleInputEvent() noexcept;
+
+  /// Requests a frame from the event loop itself, which is not woken up.
+  void requestFrame() noexcept;
+
+  /// Updates the visibility of the window. Returns true if the whole window
+  /// has to be redrawn, because it was shown, exposed or resized.
+  bool handleWindowEvent(WindowEvents event) noexcept;
+
+  bool isVisible() const noexcept;
+
+  /// Marks a frame as rendered at a point in time, which fulfills pending
+  /// requests and restarts the redraw interval.
+  void frameRendered(Clock::time_point time) noexcept;
+
+  /// Returns true if a frame should be rendered now.
+  bool isFrameDue(Clock::time_point now) const noexcept;
+
+  /// Returns the number of milliseconds the event loop may wait for events
+  /// before a frame is due, zero if one is due now, or -1 to wait until the
+  /// next event.
+  int getEventTimeout(Clock::time_point now) const noexcept;
+};
+}  // namespace dana
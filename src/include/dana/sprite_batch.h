@@ -0,0 +1,75 @@
+#pragma once
+
+#include "dana/image.h"
+#include "dana/types.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace dana {
+
+/// Collects sprites, which are parts of one image drawn to rectangles or under
+/// transforms, so they can be drawn together with Pencil::drawSprites().
+///
+/// All sprites become a single list of textured triangles. Consecutive sprites
+/// with the same tint are drawn in one draw call, so thousands of sprites with
+/// a few tints cost a few draw calls. Clearing a batch keeps its memory, so it
+/// can be filled again every frame without allocating. Source rectangles are
+/// relative to the image, also for images in a TextureAtlas.
+///
+/// The image has to outlive the batch.
+class SpriteBatch {
+  friend class Pencil;
+
+  struct Vertex {
+    float x;
+    float y;
+    float u;
+    float v;
+  };
+
+  struct Run {
+    Color tint;
+    std::size_t vertex_count;
+  };
+
+  ImageHandle m_image{0};
+  Rect m_region;
+  float m_inverse_width{0};
+  float m_inverse_height{0};
+  std::vector<Vertex> m_vertices;
+  std::vector<Run> m_runs;
+
+ public:
+  explicit SpriteBatch(const Image& image) noexcept;
+
+  /// Removes all sprites, but keeps the memory of the batch.
+  SpriteBatch& clear() noexcept;
+
+  bool isEmpty() const noexcept;
+
+  std::size_t getSpriteCount() const noexcept;
+
+  /// Returns the number of draw calls needed to draw the batch, which is the
+  /// number of runs of sprites with the same tint.
+  std::size_t getDrawCallCount() const noexcept;
+
+  /// Reserves memory for a given number of sprites.
+  SpriteBatch& reserve(std::size_t sprite_count) noexcept;
+
+  /// Adds a sprite that draws a given part of the image, in image pixels, to a
+  /// given rectangle, multiplied by a tint.
+  SpriteBatch& add(const Rect& source, const Rect& destination,
+                   const Color& tint = {255, 255, 255, 255}) noexcept;
+
+  /// Adds a sprite that draws a given part of the image, in image pixels, with
+  /// its top left corner at the origin of a given transform, multiplied by a
+  /// tint.
+  SpriteBatch& add(const Rect& source, const TransformMatrix& transform,
+                   const Color& tint = {255, 255, 255, 255}) noexcept;
+
+ private:
+  void addQuad(const Rect& source, const Vertex (&corners)[4],
+               const Color& tint) noexcept;
+};
+}  // namespace dana
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace dana {
+
+/// A bounded lock-free queue for handing items from exactly one producer
+/// thread to exactly one consumer thread.
+template <typename T>
+class SpscQueue {
+  static constexpr std::size_t cache_line_size{64};
+
+  std::vector<T> m_items;
+  std::size_t m_mask{0};
+
+  // Kept on separate cache lines, so the producer and consumer do not keep
+  // invalidating each other's cache
+  alignas(cache_line_size) std::atomic<std::size_t> m_head{0};
+  alignas(cache_line_size) std::atomic<std::size_t> m_tail{0};
+
+ public:
+  /// Constructs a queue that holds at least the given number of items. The
+  /// capacity is rounded up to a power of two.
+  explicit SpscQueue(std::size_t capacity);
+
+  /// Appends an item. Returns false if the queue is full. May only be called
+  /// from the producer thread.
+  bool tryPush(const T& item) noexcept;
+
+  /// Removes the oldest item. Returns false if the queue is empty. May only be
+  /// called from the consumer thread.
+  bool tryPop(T& item) noexcept;
+
+  /// Returns true if the queue holds no items.
+  bool isEmpty() const noexcept;
+
+  /// Returns the number of items the queue can hold.
+  std::size_t getCapacity() const noexcept;
+
+ protected:
+  SpscQueue(const SpscQueue&) = delete;
+
+  SpscQueue& operator=(const SpscQueue&) = delete;
+};
+
+template <typename T>
+SpscQueue<T>::SpscQueue(const std::size_t capacity) {
+  std::size_t size{1};
+
+  while (size < capacity) {
+    size <<= 1u;
+  }
+  m_items.resize(size);
+  m_mask = size - 1;
+}
+
+template <typename T>
+bool SpscQueue<T>::tryPush(const T& item) noexcept {
+  const auto tail{m_tail.load(std::memory_order_relaxed)};
+
+  if (tail - m_head.load(std::memory_order_acquire) == m_items.size()) {
+    return false;
+  }
+  m_items[tail & m_mask] = item;
+  m_tail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool SpscQueue<T>::tryPop(T& item) noexcept {
+  const auto head{m_head.load(std::memory_order_relaxed)};
+
+  if (head == m_tail.load(std::memory_order_acquire)) {
+    return false;
+  }
+  item = m_items[head & m_mask];
+  m_head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool SpscQueue<T>::isEmpty() const noexcept {
+  return m_head.load(std::memory_order_acquire) ==
+         m_tail.load(std::memory_order_acquire);
+}
+
+template <typename T>
+std::size_t SpscQueue<T>::getCapacity() const noexcept {
+  return m_items.size();
+}
+}  // namespace dana
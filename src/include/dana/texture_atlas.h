@@ -0,0 +1,79 @@
+#pragma once
+
+#include "dana/image.h"
+#include "dana/types.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+struct NVGcontext;
+
+namespace dana {
+
+/// Packs many small images into a few shared textures, called pages, so
+/// drawing them does not switch textures, and sprites from different images
+/// can be batched. The images are regions of the pages, and image patterns and
+/// sprite batches map them to their region of the page.
+///
+/// Images are placed with skyline packing, and surrounded by a border of
+/// repeated edge pixels so filtering does not blend in their neighbours. A new
+/// page is added when an image does not fit in any page. A page is reused once
+/// all images placed on it have been destroyed.
+///
+/// Pages have no mipmaps, and images in pages cannot repeat.
+class TextureAtlas {
+  struct Shelf {
+    int x;
+    int y;
+    int width;
+  };
+
+  struct Page {
+    std::shared_ptr<NVGcontext> context;
+    ImageHandle image;
+    std::vector<Shelf> skyline;
+
+    ~Page() noexcept;
+  };
+
+  std::shared_ptr<NVGcontext> m_context{nullptr};
+  int m_page_size;
+  int m_padding;
+  int m_image_flags;
+  std::vector<std::shared_ptr<Page>> m_pages;
+
+ public:
+  static constexpr int default_page_size{1024};
+
+  static constexpr int default_padding{1};
+
+  /// Constructs an atlas with square pages of a given size, and a border of a
+  /// given number of pixels around each image. Pages are created with the
+  /// given image flags, without mipmaps and repeating.
+  TextureAtlas(const std::shared_ptr<NVGcontext>& context,
+               int page_size = default_page_size,
+               int padding = default_padding, int image_flags = 0) noexcept;
+
+  /// Returns true if an image of a given size fits in an empty page.
+  bool fits(int width, int height) const noexcept;
+
+  /// Returns the image flags pages are created with.
+  int getImageFlags() const noexcept;
+
+  std::size_t getPageCount() const noexcept;
+
+  /// Places an image with RGBA pixels in the atlas. Returns an empty image if
+  /// it does not fit in a page.
+  Image add(int width, int height, const unsigned char* data) noexcept;
+
+ protected:
+  TextureAtlas(const TextureAtlas&) = delete;
+
+  TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+ private:
+  bool place(Page& page, int width, int height, int& x,
+             int& y) const noexcept;
+};
+}  // namespace dana
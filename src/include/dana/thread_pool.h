@@ -0,0 +1,59 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dana {
+
+/// A fixed set of worker threads that run tasks in the background.
+class ThreadPool {
+  std::vector<std::thread> m_workers;
+  std::deque<std::function<void()>> m_tasks;
+  std::size_t m_busy_workers{0};
+  bool m_stopping{false};
+
+  std::mutex m_mutex;
+  std::condition_variable m_task_added;
+  std::condition_variable m_tasks_done;
+
+ public:
+  /// Constructs a pool with a given number of worker threads.
+  explicit ThreadPool(std::size_t thread_count = getDefaultThreadCount());
+
+  /// Waits for all queued tasks to finish and stops the workers.
+  ~ThreadPool() noexcept;
+
+  /// Returns one thread less than the number of hardware threads, leaving a
+  /// core for the thread that submits work, but at least one.
+  static std::size_t getDefaultThreadCount() noexcept;
+
+  std::size_t getThreadCount() const noexcept;
+
+  /// Queues a task to run on one of the worker threads.
+  void submit(std::function<void()> task);
+
+  /// Waits until all queued tasks have finished.
+  void wait() noexcept;
+
+  /// Calls a task once for every index from zero up to the given count, and
+  /// waits until all calls have returned. The calls are spread over the worker
+  /// threads and the calling thread, in no particular order. Queued tasks do
+  /// not hold it up, since the calling thread makes the calls no worker is
+  /// free for.
+  void parallelFor(std::size_t count,
+                   const std::function<void(std::size_t)>& task);
+
+ protected:
+  ThreadPool(const ThreadPool&) = delete;
+
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+ private:
+  void work() noexcept;
+};
+}  // namespace dana
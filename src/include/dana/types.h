@@ -24,6 +24,19 @@ struct Color {
   unsigned char a{255};
 };
 
+struct Rect {
+  float x{0};
+  float y{0};
+  float width{0};
+  float height{0};
+};
+
+struct Circle {
+  float x{0};
+  float y{0};
+  float radius{0};
+};
+
 struct Paint {
   TransformMatrix transform;
   Extent extent;
@@ -1,11 +1,51 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <type_traits>
+#include <utility>
 
 namespace dana {
 
 template <typename T>
 using c_unique_ptr = std::unique_ptr<T, std::function<void(T*)>>;
 
+/// A view of a contiguous sequence of elements owned by someone else, such as
+/// a vector, an array or a plain pointer and size.
+template <typename T>
+class Span {
+  T* m_data{nullptr};
+  std::size_t m_size{0};
+
+ public:
+  constexpr Span() noexcept = default;
+
+  constexpr Span(T* data, const std::size_t size) noexcept
+      : m_data(data), m_size(size) {}
+
+  template <std::size_t N>
+  constexpr Span(T (&array)[N]) noexcept : m_data(array), m_size(N) {}
+
+  template <typename Container,
+            typename = std::enable_if_t<std::is_convertible_v<
+                decltype(std::declval<Container&>().data()), T*>>>
+  constexpr Span(Container&& container) noexcept
+      : m_data(container.data()), m_size(container.size()) {}
+
+  constexpr T* data() const noexcept { return m_data; }
+
+  constexpr std::size_t size() const noexcept { return m_size; }
+
+  constexpr bool empty() const noexcept { return m_size == 0; }
+
+  constexpr T* begin() const noexcept { return m_data; }
+
+  constexpr T* end() const noexcept { return m_data + m_size; }
+
+  constexpr T& operator[](const std::size_t index) const noexcept {
+    return m_data[index];
+  }
+};
+
 }  // namespace dana
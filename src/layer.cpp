@@ -0,0 +1,134 @@
+#include "dana/layer.h"
+
+#include <GL/glew.h>
+
+#include <cmath>
+
+namespace dana {
+
+Layer::Layer(const int width, const int height) noexcept
+    : m_width{width}, m_height{height} {}
+
+Layer& Layer::onDraw(const DrawCallback& draw_callback) noexcept {
+  m_draw_callback = draw_callback;
+  invalidate();
+  return *this;
+}
+
+Layer& Layer::setSize(const int width, const int height) noexcept {
+  m_width = width;
+  m_height = height;
+  invalidate();
+  return *this;
+}
+
+std::pair<int, int> Layer::getSize() const noexcept {
+  return {m_width, m_height};
+}
+
+Layer& Layer::setTransform(const TransformMatrix& transform) noexcept {
+  m_transform = transform;
+  notifyChanged();
+  return *this;
+}
+
+const TransformMatrix& Layer::getTransform() const noexcept {
+  return m_transform;
+}
+
+Layer& Layer::setOpacity(const unsigned char opacity) noexcept {
+  m_opacity = opacity;
+  notifyChanged();
+  return *this;
+}
+
+unsigned char Layer::getOpacity() const noexcept { return m_opacity; }
+
+Layer& Layer::setZOrder(const int z_order) noexcept {
+  m_z_order = z_order;
+  notifyChanged();
+  return *this;
+}
+
+int Layer::getZOrder() const noexcept { return m_z_order; }
+
+Layer& Layer::setVisible(const bool visible) noexcept {
+  m_visible = visible;
+  notifyChanged();
+  return *this;
+}
+
+bool Layer::isVisible() const noexcept { return m_visible; }
+
+void Layer::invalidate() noexcept {
+  m_invalidated = true;
+  notifyChanged();
+}
+
+uint64_t Layer::getRenderCount() const noexcept { return m_render_count; }
+
+bool Layer::render(Pencil& pencil, FramebufferPool& pool,
+                   const float pixel_ratio) {
+  if (m_width <= 0 || m_height <= 0) {
+    return false;
+  }
+  // Render at the resolution of the canvas, so Hi-DPI layers stay sharp
+  const auto width{static_cast<int>(std::ceil(m_width * pixel_ratio))};
+  const auto height{static_cast<int>(std::ceil(m_height * pixel_ratio))};
+
+  if (nullptr != m_framebuffer &&
+      m_framebuffer->getSize() != std::make_pair(width, height)) {
+    release(pool);
+  }
+  if (!m_invalidated && nullptr != m_framebuffer) {
+    return false;
+  }
+  if (nullptr == m_framebuffer) {
+    m_framebuffer = pool.acquire(width, height);
+    m_image = pencil.createImage(*m_framebuffer);
+  }
+  m_framebuffer->bind();
+  glViewport(0, 0, width, height);
+  glClearColor(0, 0, 0, 0);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+  pencil.beginFrame(static_cast<float>(m_width), static_cast<float>(m_height),
+                    pixel_ratio);
+  m_draw_callback(pencil);
+  pencil.endFrame();
+
+  m_invalidated = false;
+  ++m_render_count;
+  return true;
+}
+
+void Layer::composite(Pencil& pencil) const noexcept {
+  if (!m_visible || nullptr == m_framebuffer) {
+    return;
+  }
+  const auto width{static_cast<float>(m_width)};
+  const auto height{static_cast<float>(m_height)};
+
+  pencil.save()
+      .reset()
+      .transform(m_transform)
+      .beginPath()
+      .rectangle(0, 0, width, height)
+      .setFillPaint(pencil.createImagePattern(m_image, 0, 0, width, height, 0,
+                                              m_opacity))
+      .fill()
+      .restore();
+}
+
+void Layer::release(FramebufferPool& pool) noexcept {
+  m_image = Image();
+  pool.release(std::move(m_framebuffer));
+  m_invalidated = true;
+}
+
+void Layer::notifyChanged() const noexcept {
+  if (m_changed_callback) {
+    m_changed_callback();
+  }
+}
+}  // namespace dana
@@ -0,0 +1,312 @@
+#include "dana/path.h"
+
+#include <nanovg/nanovg.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace dana {
+
+// Scales within a quarter octave of each other share cached geometry, which
+// keeps the error in stroke width and anti-aliasing below 10%
+static constexpr float scale_buckets_per_octave{4};
+
+// Returns true if the transform only translates, rotates and scales uniformly
+static bool isSimilarity(const std::array<float, 6>& transform,
+                         const float scale) noexcept {
+  constexpr float tolerance{1e-4f};
+  return scale > 0 &&
+         std::abs(transform[0] - transform[3]) <= tolerance * scale &&
+         std::abs(transform[1] + transform[2]) <= tolerance * scale;
+}
+
+bool Path::GeometryKey::operator==(const GeometryKey& other) const noexcept {
+  return stroke == other.stroke && scale_bucket == other.scale_bucket &&
+         pixel_ratio == other.pixel_ratio && anti_alias == other.anti_alias &&
+         stroke_width == other.stroke_width &&
+         miter_limit == other.miter_limit && line_cap == other.line_cap &&
+         line_join == other.line_join;
+}
+
+Path& Path::moveTo(const float x, const float y) noexcept {
+  return append(Verbs::MOVE_TO, {x, y});
+}
+
+Path& Path::lineTo(const float x, const float y) noexcept {
+  return append(Verbs::LINE_TO, {x, y});
+}
+
+Path& Path::bezierTo(const float c1x, const float c1y, const float c2x,
+                     const float c2y, const float x, const float y) noexcept {
+  return append(Verbs::BEZIER_TO, {c1x, c1y, c2x, c2y, x, y});
+}
+
+Path& Path::quadTo(const float cx, const float cy, const float x,
+                   const float y) noexcept {
+  return append(Verbs::QUAD_TO, {cx, cy, x, y});
+}
+
+Path& Path::arcTo(const float x1, const float y1, const float x2,
+                  const float y2, const float radius) noexcept {
+  return append(Verbs::ARC_TO, {x1, y1, x2, y2, radius});
+}
+
+Path& Path::closePath() noexcept { return append(Verbs::CLOSE_PATH, {}); }
+
+Path& Path::setPathFillRule(const Solidity solidity) noexcept {
+  return append(Verbs::FILL_RULE,
+                {solidity == Solidity::SOLID ? 0.0f : 1.0f});
+}
+
+Path& Path::arc(const float center_x, const float center_y,
+                const float radius, const float start_angle,
+                const float end_angle, const Direction direction) noexcept {
+  return append(Verbs::ARC,
+                {center_x, center_y, radius, start_angle, end_angle,
+                 direction == Direction::CLOCKWISE ? 0.0f : 1.0f});
+}
+
+Path& Path::rectangle(const float x, const float y, const float width,
+                      const float height) noexcept {
+  return append(Verbs::RECTANGLE, {x, y, width, height});
+}
+
+Path& Path::roundedRectangle(const float x, const float y, const float width,
+                             const float height,
+                             const float radius) noexcept {
+  return roundedRectangle(x, y, width, height, radius, radius, radius, radius);
+}
+
+Path& Path::roundedRectangle(const float x, const float y, const float width,
+                             const float height, const float radius_top_left,
+                             const float radius_top_right,
+                             const float radius_bottom_right,
+                             const float radius_bottom_left) noexcept {
+  return append(Verbs::ROUNDED_RECTANGLE,
+                {x, y, width, height, radius_top_left, radius_top_right,
+                 radius_bottom_right, radius_bottom_left});
+}
+
+Path& Path::ellipse(const float center_x, const float center_y,
+                    const float radius_x, const float radius_y) noexcept {
+  return append(Verbs::ELLIPSE, {center_x, center_y, radius_x, radius_y});
+}
+
+Path& Path::circle(const float center_x, const float center_y,
+                   const float radius) noexcept {
+  return append(Verbs::CIRCLE, {center_x, center_y, radius});
+}
+
+Path& Path::clear() noexcept {
+  m_commands.clear();
+  m_cache = nullptr;
+  return *this;
+}
+
+bool Path::isEmpty() const noexcept { return m_commands.empty(); }
+
+std::size_t Path::getCachedGeometryCount() const noexcept {
+  return m_cache ? m_cache->entries.size() : 0;
+}
+
+uint64_t Path::getTessellationCount() const noexcept {
+  return m_cache ? m_cache->tessellation_count : 0;
+}
+
+Path& Path::append(const Verbs verb,
+                   const std::array<float, 8> values) noexcept {
+  m_commands.push_back({verb, values});
+  // Copies of the path may still draw the old geometry
+  m_cache = nullptr;
+  return *this;
+}
+
+void Path::build(NVGcontext* context) const noexcept {
+  nvgBeginPath(context);
+
+  for (const auto& command : m_commands) {
+    const auto& v{command.values};
+
+    switch (command.verb) {
+      case Verbs::MOVE_TO:
+        nvgMoveTo(context, v[0], v[1]);
+        break;
+      case Verbs::LINE_TO:
+        nvgLineTo(context, v[0], v[1]);
+        break;
+      case Verbs::BEZIER_TO:
+        nvgBezierTo(context, v[0], v[1], v[2], v[3], v[4], v[5]);
+        break;
+      case Verbs::QUAD_TO:
+        nvgQuadTo(context, v[0], v[1], v[2], v[3]);
+        break;
+      case Verbs::ARC_TO:
+        nvgArcTo(context, v[0], v[1], v[2], v[3], v[4]);
+        break;
+      case Verbs::CLOSE_PATH:
+        nvgClosePath(context);
+        break;
+      case Verbs::FILL_RULE:
+        nvgPathWinding(context, v[0] == 0 ? NVG_SOLID : NVG_HOLE);
+        break;
+      case Verbs::ARC:
+        nvgArc(context, v[0], v[1], v[2], v[3], v[4],
+               v[5] == 0 ? NVG_CW : NVG_CCW);
+        break;
+      case Verbs::RECTANGLE:
+        nvgRect(context, v[0], v[1], v[2], v[3]);
+        break;
+      case Verbs::ROUNDED_RECTANGLE:
+        nvgRoundedRectVarying(context, v[0], v[1], v[2], v[3], v[4], v[5],
+                              v[6], v[7]);
+        break;
+      case Verbs::ELLIPSE:
+        nvgEllipse(context, v[0], v[1], v[2], v[3]);
+        break;
+      case Verbs::CIRCLE:
+        nvgCircle(context, v[0], v[1], v[2]);
+        break;
+    }
+  }
+}
+
+void Path::draw(NVGcontext* context, const bool stroke) const noexcept {
+  std::array<float, 6> transform{};
+  nvgCurrentTransform(context, transform.data());
+
+  const float scale{std::hypot(transform[0], transform[1])};
+  NVGgeometry* geometry{nullptr};
+  float bucket_scale{1};
+
+  if (isSimilarity(transform, scale)) {
+    geometry = getGeometry(context, stroke, scale, bucket_scale);
+  }
+  if (geometry == nullptr) {
+    build(context);
+    stroke ? nvgStroke(context) : nvgFill(context);
+    return;
+  }
+  // The geometry was tessellated at the bucket scale, so only the remaining
+  // scale, rotation and translation are applied to its vertices
+  const std::array<float, 6> remaining{
+      transform[0] / bucket_scale, transform[1] / bucket_scale,
+      transform[2] / bucket_scale, transform[3] / bucket_scale,
+      transform[4],                transform[5]};
+  nvgDrawGeometry(context, geometry, remaining.data());
+}
+
+void Path::drawInstances(NVGcontext* context,
+                         const Span<const TransformMatrix> transforms,
+                         const Span<const Color> colors) const noexcept {
+  static_assert(sizeof(TransformMatrix) == 6 * sizeof(float),
+                "Transforms are passed to nanovg as arrays of floats");
+
+  std::array<float, 6> transform{};
+  nvgCurrentTransform(context, transform.data());
+
+  // Instances are expected to be drawn at a similar scale, so the geometry is
+  // tessellated for the average scale of the current transform
+  const float scale{std::sqrt(std::abs(transform[0] * transform[3] -
+                                       transform[1] * transform[2]))};
+  if (transforms.empty() || scale <= 0) {
+    return;
+  }
+  // Without a color for every instance, the later ones would have none
+  if (colors.size() > 1 && colors.size() != transforms.size()) {
+    return;
+  }
+  float bucket_scale{1};
+  const auto geometry{getGeometry(context, false, scale, bucket_scale)};
+
+  if (geometry == nullptr) {
+    return;
+  }
+  // Each instance maps the geometry back from the bucket scale, then applies
+  // its own transform, and then the current one
+  std::vector<float> instances(transforms.size() * 6);
+
+  for (std::size_t i = 0; i < transforms.size(); ++i) {
+    float* instance{&instances[i * 6]};
+    nvgTransformScale(instance, 1 / bucket_scale, 1 / bucket_scale);
+    nvgTransformMultiply(
+        instance, reinterpret_cast<const float*>(&transforms[i]));
+    nvgTransformMultiply(instance, transform.data());
+  }
+  std::vector<NVGcolor> instance_colors;
+  instance_colors.reserve(colors.size());
+
+  for (const auto& color : colors) {
+    instance_colors.push_back(nvgRGBA(color.r, color.g, color.b, color.a));
+  }
+  nvgDrawInstances(context, geometry, instances.data(),
+                   instance_colors.data(),
+                   static_cast<int>(instance_colors.size()),
+                   static_cast<int>(transforms.size()));
+}
+
+NVGgeometry* Path::getGeometry(NVGcontext* context, const bool stroke,
+                               const float scale,
+                               float& bucket_scale) const noexcept {
+  GeometryKey key{stroke, 0, nvgDevicePixelRatio(context),
+                  nvgCurrentAntiAlias(context) != 0, 0, 0, 0, 0};
+  key.scale_bucket = static_cast<int>(
+      std::lround(std::log2(scale) * scale_buckets_per_octave));
+  bucket_scale = std::exp2(key.scale_bucket / scale_buckets_per_octave);
+
+  if (stroke) {
+    nvgCurrentStrokeStyle(context, &key.stroke_width, &key.miter_limit,
+                          &key.line_cap, &key.line_join);
+  }
+  NVGgeometry* geometry{findGeometry(key)};
+
+  if (geometry == nullptr) {
+    geometry = tessellate(context, key, bucket_scale);
+  }
+  return geometry;
+}
+
+NVGgeometry* Path::findGeometry(const GeometryKey& key) const noexcept {
+  if (!m_cache) {
+    return nullptr;
+  }
+  for (auto& entry : m_cache->entries) {
+    if (entry.key == key) {
+      entry.last_use = ++m_cache->use_count;
+      return entry.geometry.get();
+    }
+  }
+  return nullptr;
+}
+
+NVGgeometry* Path::tessellate(NVGcontext* context, const GeometryKey& key,
+                              const float scale) const noexcept {
+  nvgSave(context);
+  nvgResetTransform(context);
+  nvgScale(context, scale, scale);
+  build(context);
+  c_unique_ptr<NVGgeometry> geometry{
+      key.stroke ? nvgCreateStrokeGeometry(context)
+                 : nvgCreateFillGeometry(context),
+      [](NVGgeometry* ptr) { nvgDeleteGeometry(ptr); }};
+  nvgRestore(context);
+
+  if (!geometry) {
+    return nullptr;
+  }
+  if (!m_cache) {
+    m_cache = std::make_shared<GeometryCache>();
+  }
+  auto& entries{m_cache->entries};
+
+  if (entries.size() >= max_cached_geometries) {
+    entries.erase(std::min_element(
+        entries.begin(), entries.end(),
+        [](const CachedGeometry& a, const CachedGeometry& b) {
+          return a.last_use < b.last_use;
+        }));
+  }
+  entries.push_back({key, std::move(geometry), ++m_cache->use_count});
+  ++m_cache->tessellation_count;
+  return entries.back().geometry.get();
+}
+}  // namespace dana
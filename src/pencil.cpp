@@ -8,8 +8,11 @@
 #include <nanovg/nanovg.h>
 #include <nanovg/nanovg_gl.h>
 #include <nanovg/nanovg_gl_utils.h>
+#include <nanovg/stb_image.h>
 
+#include <algorithm>
 #include <array>
+#include <climits>
 
 namespace dana {
 
@@ -176,6 +179,48 @@ Pencil::Pencil() {
 Pencil& Pencil::beginFrame(const float width, const float height,
                            const float pixel_ratio) noexcept {
   nvgBeginFrame(m_context.get(), width, height, pixel_ratio);
+  ++m_frame_count;
+  return *this;
+}
+
+uint64_t Pencil::getFrameCount() const noexcept {
+  return m_frame_count;
+}
+
+Pencil& Pencil::setStreamBufferSize(const std::size_t size) noexcept {
+  constexpr std::size_t max_size{static_cast<std::size_t>(INT_MAX)};
+  nvglSetStreamBufferSizeGL3(m_context.get(),
+                             static_cast<int>(std::min(size, max_size)));
+  return *this;
+}
+
+Pencil& Pencil::setDrawCallReordering(const bool enabled) noexcept {
+  nvglSetReorderCallsGL3(m_context.get(), enabled ? 1 : 0);
+  return *this;
+}
+
+RenderStatistics Pencil::getRenderStatistics() const noexcept {
+  NVGLstats stats;
+  nvglGetStatsGL3(m_context.get(), &stats, 0);
+
+  RenderStatistics statistics;
+  statistics.flushes = static_cast<uint64_t>(stats.flushes);
+  statistics.stream_wraps = static_cast<uint64_t>(stats.streamWraps);
+  statistics.stream_stalls = static_cast<uint64_t>(stats.streamStalls);
+  statistics.stream_orphans = static_cast<uint64_t>(stats.streamOrphans);
+  statistics.calls = static_cast<uint64_t>(stats.calls);
+  statistics.merged_calls = static_cast<uint64_t>(stats.mergedCalls);
+  statistics.draw_calls = static_cast<uint64_t>(stats.drawCalls);
+  statistics.instanced_calls = static_cast<uint64_t>(stats.instancedCalls);
+  statistics.submitted_state_changes =
+      static_cast<uint64_t>(stats.submittedStateChanges);
+  statistics.state_changes = static_cast<uint64_t>(stats.stateChanges);
+  return statistics;
+}
+
+Pencil& Pencil::resetRenderStatistics() noexcept {
+  NVGLstats stats;
+  nvglGetStatsGL3(m_context.get(), &stats, 1);
   return *this;
 }
 
@@ -378,6 +423,17 @@ Pencil& Pencil::resetScissor() noexcept {
   return *this;
 }
 
+Pencil& Pencil::setClipRect(const int x, const int y, const int width,
+                            const int height) noexcept {
+  nvglSetClipRectGL3(m_context.get(), x, y, width, height);
+  return *this;
+}
+
+Pencil& Pencil::resetClipRect() noexcept {
+  nvglSetClipRectGL3(m_context.get(), 0, 0, -1, -1);
+  return *this;
+}
+
 Pencil& Pencil::beginPath() noexcept {
   nvgBeginPath(m_context.get());
   return *this;
@@ -464,6 +520,30 @@ Pencil& Pencil::circle(const float center_x, const float center_y,
   return *this;
 }
 
+Pencil& Pencil::rectangles(const Span<const Rect> rects) noexcept {
+  static_assert(sizeof(Rect) == 4 * sizeof(float),
+                "Rectangles are passed to nanovg as arrays of floats");
+
+  nvgRects(m_context.get(), reinterpret_cast<const float*>(rects.data()),
+           static_cast<int>(rects.size()));
+  return *this;
+}
+
+Pencil& Pencil::circles(const Span<const Circle> circles) noexcept {
+  static_assert(sizeof(Circle) == 3 * sizeof(float),
+                "Circles are passed to nanovg as arrays of floats");
+
+  nvgCircles(m_context.get(), reinterpret_cast<const float*>(circles.data()),
+             static_cast<int>(circles.size()));
+  return *this;
+}
+
+Pencil& Pencil::lineSegments(const Span<const float> points) noexcept {
+  nvgLineSegments(m_context.get(), points.data(),
+                  static_cast<int>(points.size() / 4));
+  return *this;
+}
+
 Pencil& Pencil::fill() noexcept {
   nvgFill(m_context.get());
   return *this;
@@ -474,8 +554,50 @@ Pencil& Pencil::stroke() noexcept {
   return *this;
 }
 
+Pencil& Pencil::fill(const Path& path) noexcept {
+  path.draw(m_context.get(), false);
+  return *this;
+}
+
+Pencil& Pencil::stroke(const Path& path) noexcept {
+  path.draw(m_context.get(), true);
+  return *this;
+}
+
+Pencil& Pencil::drawInstances(const Path& shape,
+                              const Span<const TransformMatrix> transforms,
+                              const Span<const Color> colors) noexcept {
+  shape.drawInstances(m_context.get(), transforms, colors);
+  return *this;
+}
+
+Pencil& Pencil::drawSprites(const SpriteBatch& batch) noexcept {
+  static_assert(sizeof(SpriteBatch::Vertex) == sizeof(NVGvertex),
+                "Sprite vertices are passed to nanovg as they are");
+
+  const auto* vertices{
+      reinterpret_cast<const NVGvertex*>(batch.m_vertices.data())};
+
+  for (const auto& run : batch.m_runs) {
+    nvgDrawTriangles(m_context.get(), batch.m_image, convert(run.tint),
+                     vertices, static_cast<int>(run.vertex_count));
+    vertices += run.vertex_count;
+  }
+  return *this;
+}
+
 Image Pencil::createImage(const std::string& filename, int image_flags) const
     noexcept {
+  // Decoded here, so the image can be placed in the atlas
+  if (m_texture_atlas != nullptr) {
+    int width{0};
+    int height{0};
+    int components{0};
+    const c_unique_ptr<unsigned char> pixels{
+        stbi_load(filename.c_str(), &width, &height, &components, 4),
+        [](unsigned char* ptr) { stbi_image_free(ptr); }};
+    return createImage(width, height, pixels.get(), image_flags);
+  }
   const auto image_handle{
       nvgCreateImage(m_context.get(), filename.c_str(), image_flags)};
   return Image(m_context, image_handle);
@@ -483,11 +605,103 @@ Image Pencil::createImage(const std::string& filename, int image_flags) const
 
 Image Pencil::createImage(unsigned char* data, const int size,
                           const int image_flags) const noexcept {
+  // Decoded here, so the image can be placed in the atlas
+  if (m_texture_atlas != nullptr) {
+    int width{0};
+    int height{0};
+    int components{0};
+    const c_unique_ptr<unsigned char> pixels{
+        stbi_load_from_memory(data, size, &width, &height, &components, 4),
+        [](unsigned char* ptr) { stbi_image_free(ptr); }};
+    return createImage(width, height, pixels.get(), image_flags);
+  }
   const auto image_handle{
       nvgCreateImageMem(m_context.get(), image_flags, data, size)};
   return Image(m_context, image_handle);
 }
 
+Image Pencil::createImage(const int width, const int height,
+                          const unsigned char* pixels,
+                          const int image_flags) const noexcept {
+  if (pixels == nullptr) {
+    return Image(m_context, 0);
+  }
+  // Pages are created with the flags of the atlas, so images with other
+  // flags would lose them there
+  if (m_texture_atlas != nullptr &&
+      image_flags == m_texture_atlas->getImageFlags() &&
+      m_texture_atlas->fits(width, height)) {
+    auto image{m_texture_atlas->add(width, height, pixels)};
+
+    if (image.getHandle()) {
+      return image;
+    }
+  }
+  const auto image_handle{
+      nvgCreateImageRGBA(m_context.get(), width, height, image_flags, pixels)};
+  return Image(m_context, image_handle);
+}
+
+Image Pencil::createImage(ImageData& image_data,
+                          const int image_flags) const noexcept {
+  const auto size{image_data.getSize()};
+  image_data.clearDirty();
+  return createImage(size.first, size.second, image_data.getPixels(),
+                     image_flags);
+}
+
+Pencil& Pencil::putImageData(const Image& image,
+                             ImageData& image_data) noexcept {
+  const auto size{image_data.getSize()};
+
+  if (!image.getHandle() || image.getSize() != size) {
+    return *this;
+  }
+  // Images in a shared texture are updated within their region
+  const auto region{image.getRegion()};
+
+  for (const auto& rect : image_data.getDirtyRects()) {
+    const int x{static_cast<int>(rect.x)};
+    const int y{static_cast<int>(rect.y)};
+    const auto* pixels{image_data.getPixels() +
+                       (static_cast<std::size_t>(y) * size.first + x) * 4};
+    nvgUpdateImageRegion(m_context.get(), *image.getHandle(),
+                         static_cast<int>(region.x) + x,
+                         static_cast<int>(region.y) + y,
+                         static_cast<int>(rect.width),
+                         static_cast<int>(rect.height), size.first, pixels);
+  }
+  image_data.clearDirty();
+  return *this;
+}
+
+Image Pencil::createImage(const AssetPack& pack, const std::string& name,
+                          const int image_flags) const noexcept {
+  const auto* image{pack.find(name)};
+
+  if (image == nullptr) {
+    return Image();
+  }
+  const int type{image->format == PixelFormat::ALPHA ? NVG_TEXTURE_ALPHA
+                                                     : NVG_TEXTURE_RGBA};
+  const auto image_handle{nvgCreateImageLevels(
+      m_context.get(), type, image->width, image->height,
+      image->image_flags | image_flags, image->levels.data(),
+      static_cast<int>(image->levels.size()))};
+  return Image(m_context, image_handle);
+}
+
+Image Pencil::createImage(const Framebuffer& framebuffer) const noexcept {
+  // Framebuffers are rendered upside down with premultiplied alpha
+  constexpr int image_flags{NVG_IMAGE_FLIPY | NVG_IMAGE_PREMULTIPLIED |
+                            NVG_IMAGE_NODELETE};
+  const auto size{framebuffer.getSize()};
+  const auto image_handle{nvglCreateImageFromHandleGL3(
+      m_context.get(), framebuffer.getTexture(), size.first, size.second,
+      image_flags)};
+  return Image(m_context, image_handle);
+}
+
 Paint Pencil::createImagePattern(const Image& image, const float top_left_x,
                                  const float top_left_y, const float width,
                                  const float height, const float angle,
@@ -495,8 +709,38 @@ Paint Pencil::createImagePattern(const Image& image, const float top_left_x,
   auto image_pattern{convert(
       nvgImagePattern(m_context.get(), top_left_x, top_left_y, width, height,
                       angle, *image.getHandle(), convertAlpha(alpha)))};
+
+  if (image.isSharedTexture()) {
+    // Stretch the pattern over the whole texture, and move it so the region of
+    // the image lands on the given rectangle
+    const auto texture_size{image.getTextureSize()};
+    const auto region{image.getRegion()};
+    const float scale_x{width / region.width};
+    const float scale_y{height / region.height};
+    const float offset_x{region.x * scale_x};
+    const float offset_y{region.y * scale_y};
+    auto& transform{image_pattern.transform};
+
+    image_pattern.extent = {texture_size.first * scale_x,
+                            texture_size.second * scale_y};
+    transform.horizontal_moving -= transform.horizontal_scaling * offset_x +
+                                   transform.vertical_skewing * offset_y;
+    transform.vertical_moving -= transform.horizontal_skewing * offset_x +
+                                 transform.vertical_scaling * offset_y;
+  }
   image_pattern.inner_color = {255, 255, 255, alpha};
   image_pattern.outer_color = {255, 255, 255, alpha};
   return image_pattern;
 }
+
+TextureAtlas Pencil::createTextureAtlas(const int page_size,
+                                        const int padding,
+                                        const int image_flags) const noexcept {
+  return TextureAtlas(m_context, page_size, padding, image_flags);
+}
+
+Pencil& Pencil::setTextureAtlas(TextureAtlas* atlas) noexcept {
+  m_texture_atlas = atlas;
+  return *this;
+}
 }  // namespace dana
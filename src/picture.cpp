@@ -0,0 +1,464 @@
+#include "dana/picture.h"
+
+namespace dana {
+
+namespace {
+
+// Reads records back in the order they were written. Arguments are copied
+// out, as records are packed without padding.
+class Reader {
+  const unsigned char* m_data;
+
+ public:
+  explicit Reader(const unsigned char* data) noexcept : m_data{data} {}
+
+  template <typename T>
+  T read() noexcept {
+    T value;
+    std::memcpy(&value, m_data, sizeof(T));
+    m_data += sizeof(T);
+    return value;
+  }
+
+  float f() noexcept { return read<float>(); }
+
+  const unsigned char* position() const noexcept { return m_data; }
+};
+
+// Paint holds a std::pair, which cannot be copied as raw bytes
+struct PaintRecord {
+  TransformMatrix transform;
+  float extent[2];
+  float radius;
+  float feather;
+  Color inner_color;
+  Color outer_color;
+  ImageHandle image;
+};
+
+PaintRecord toRecord(const Paint& paint) noexcept {
+  return {paint.transform,   {paint.extent.first, paint.extent.second},
+          paint.radius,      paint.feather,
+          paint.inner_color, paint.outer_color,
+          paint.image};
+}
+
+Paint toPaint(const PaintRecord& record) noexcept {
+  return {record.transform,   {record.extent[0], record.extent[1]},
+          record.radius,      record.feather,
+          record.inner_color, record.outer_color,
+          record.image};
+}
+}  // namespace
+
+Picture& Picture::clear() noexcept {
+  m_buffer.clear();
+  m_command_count = 0;
+  return *this;
+}
+
+bool Picture::isEmpty() const noexcept { return m_command_count == 0; }
+
+std::size_t Picture::getCommandCount() const noexcept {
+  return m_command_count;
+}
+
+std::size_t Picture::getSize() const noexcept { return m_buffer.size(); }
+
+Picture& Picture::reserve(const std::size_t size) noexcept {
+  m_buffer.reserve(size);
+  return *this;
+}
+
+void Picture::replay(Pencil& pencil) const noexcept {
+  Reader reader(m_buffer.data());
+  const auto* end{m_buffer.data() + m_buffer.size()};
+
+  while (reader.position() < end) {
+    switch (reader.read<Opcodes>()) {
+      case Opcodes::SET_GLOBAL_COMPOSITE_OPERATION:
+        pencil.setGlobalCompositeOperation(
+            reader.read<CompositeOperations>());
+        break;
+      case Opcodes::SET_GLOBAL_COMPOSITE_BLEND_FUNC_SEPARATE: {
+        const auto src_rgb{reader.read<BlendFactors>()};
+        const auto dst_rgb{reader.read<BlendFactors>()};
+        const auto src_alpha{reader.read<BlendFactors>()};
+        const auto dst_alpha{reader.read<BlendFactors>()};
+        pencil.setGlobalCompositeBlendFuncSeparate(src_rgb, dst_rgb,
+                                                   src_alpha, dst_alpha);
+        break;
+      }
+      case Opcodes::SAVE:
+        pencil.save();
+        break;
+      case Opcodes::RESTORE:
+        pencil.restore();
+        break;
+      case Opcodes::RESET:
+        pencil.reset();
+        break;
+      case Opcodes::SET_ANTI_ALIAS:
+        pencil.setAntiAlias(reader.read<bool>());
+        break;
+      case Opcodes::SET_STROKE_COLOR:
+        pencil.setStrokeColor(reader.read<Color>());
+        break;
+      case Opcodes::SET_STROKE_PAINT:
+        pencil.setStrokePaint(toPaint(reader.read<PaintRecord>()));
+        break;
+      case Opcodes::SET_FILL_COLOR:
+        pencil.setFillColor(reader.read<Color>());
+        break;
+      case Opcodes::SET_FILL_PAINT:
+        pencil.setFillPaint(toPaint(reader.read<PaintRecord>()));
+        break;
+      case Opcodes::SET_MITER_LIMIT:
+        pencil.setMiterLimit(reader.f());
+        break;
+      case Opcodes::SET_STROKE_WIDTH:
+        pencil.setStrokeWidth(reader.f());
+        break;
+      case Opcodes::SET_LINE_CAP:
+        pencil.setLineCap(reader.read<LineCap>());
+        break;
+      case Opcodes::SET_LINE_JOIN:
+        pencil.setLineJoin(reader.read<LineJoin>());
+        break;
+      case Opcodes::SET_GLOBAL_ALPHA:
+        pencil.setGlobalAlpha(reader.read<unsigned char>());
+        break;
+      case Opcodes::RESET_TRANSFORM:
+        pencil.resetTransform();
+        break;
+      case Opcodes::TRANSFORM:
+        pencil.transform(reader.read<TransformMatrix>());
+        break;
+      case Opcodes::TRANSLATE: {
+        const auto x{reader.f()};
+        pencil.translate(x, reader.f());
+        break;
+      }
+      case Opcodes::ROTATE:
+        pencil.rotate(reader.f());
+        break;
+      case Opcodes::SKEW_X:
+        pencil.skewX(reader.f());
+        break;
+      case Opcodes::SKEW_Y:
+        pencil.skewY(reader.f());
+        break;
+      case Opcodes::SCALE: {
+        const auto x{reader.f()};
+        pencil.scale(x, reader.f());
+        break;
+      }
+      case Opcodes::SCISSOR: {
+        const auto rect{reader.read<Rect>()};
+        pencil.scissor(rect.x, rect.y, rect.width, rect.height);
+        break;
+      }
+      case Opcodes::INTERSECT_SCISSOR: {
+        const auto rect{reader.read<Rect>()};
+        pencil.intersectScissor(rect.x, rect.y, rect.width, rect.height);
+        break;
+      }
+      case Opcodes::RESET_SCISSOR:
+        pencil.resetScissor();
+        break;
+      case Opcodes::BEGIN_PATH:
+        pencil.beginPath();
+        break;
+      case Opcodes::MOVE_TO: {
+        const auto x{reader.f()};
+        pencil.moveTo(x, reader.f());
+        break;
+      }
+      case Opcodes::LINE_TO: {
+        const auto x{reader.f()};
+        pencil.lineTo(x, reader.f());
+        break;
+      }
+      case Opcodes::BEZIER_TO: {
+        const auto c1x{reader.f()};
+        const auto c1y{reader.f()};
+        const auto c2x{reader.f()};
+        const auto c2y{reader.f()};
+        const auto x{reader.f()};
+        pencil.bezierTo(c1x, c1y, c2x, c2y, x, reader.f());
+        break;
+      }
+      case Opcodes::QUAD_TO: {
+        const auto cx{reader.f()};
+        const auto cy{reader.f()};
+        const auto x{reader.f()};
+        pencil.quadTo(cx, cy, x, reader.f());
+        break;
+      }
+      case Opcodes::ARC_TO: {
+        const auto x1{reader.f()};
+        const auto y1{reader.f()};
+        const auto x2{reader.f()};
+        const auto y2{reader.f()};
+        pencil.arcTo(x1, y1, x2, y2, reader.f());
+        break;
+      }
+      case Opcodes::CLOSE_PATH:
+        pencil.closePath();
+        break;
+      case Opcodes::SET_PATH_FILL_RULE:
+        pencil.setPathFillRule(reader.read<Solidity>());
+        break;
+      case Opcodes::ARC: {
+        const auto center_x{reader.f()};
+        const auto center_y{reader.f()};
+        const auto radius{reader.f()};
+        const auto start_angle{reader.f()};
+        const auto end_angle{reader.f()};
+        pencil.arc(center_x, center_y, radius, start_angle, end_angle,
+                   reader.read<Direction>());
+        break;
+      }
+      case Opcodes::RECTANGLE: {
+        const auto rect{reader.read<Rect>()};
+        pencil.rectangle(rect.x, rect.y, rect.width, rect.height);
+        break;
+      }
+      case Opcodes::ROUNDED_RECTANGLE: {
+        const auto rect{reader.read<Rect>()};
+        const auto top_left{reader.f()};
+        const auto top_right{reader.f()};
+        const auto bottom_right{reader.f()};
+        pencil.roundedRectangle(rect.x, rect.y, rect.width, rect.height,
+                                top_left, top_right, bottom_right,
+                                reader.f());
+        break;
+      }
+      case Opcodes::ELLIPSE: {
+        const auto center_x{reader.f()};
+        const auto center_y{reader.f()};
+        const auto radius_x{reader.f()};
+        pencil.ellipse(center_x, center_y, radius_x, reader.f());
+        break;
+      }
+      case Opcodes::CIRCLE: {
+        const auto center_x{reader.f()};
+        const auto center_y{reader.f()};
+        pencil.circle(center_x, center_y, reader.f());
+        break;
+      }
+      case Opcodes::FILL:
+        pencil.fill();
+        break;
+      case Opcodes::STROKE:
+        pencil.stroke();
+        break;
+      case Opcodes::FILL_PATH:
+        pencil.fill(*reader.read<const Path*>());
+        break;
+      case Opcodes::STROKE_PATH:
+        pencil.stroke(*reader.read<const Path*>());
+        break;
+    }
+  }
+}
+
+Picture& Picture::setGlobalCompositeOperation(
+    const CompositeOperations composite_operation) noexcept {
+  return record(Opcodes::SET_GLOBAL_COMPOSITE_OPERATION, composite_operation);
+}
+
+Picture& Picture::setGlobalCompositeBlendFunc(
+    const BlendFactors src_factor, const BlendFactors dst_factor) noexcept {
+  return setGlobalCompositeBlendFuncSeparate(src_factor, dst_factor,
+                                             src_factor, dst_factor);
+}
+
+Picture& Picture::setGlobalCompositeBlendFuncSeparate(
+    const BlendFactors src_rgb, const BlendFactors dst_rgb,
+    const BlendFactors src_alpha, const BlendFactors dst_alpha) noexcept {
+  return record(Opcodes::SET_GLOBAL_COMPOSITE_BLEND_FUNC_SEPARATE, src_rgb,
+                dst_rgb, src_alpha, dst_alpha);
+}
+
+Picture& Picture::save() noexcept { return record(Opcodes::SAVE); }
+
+Picture& Picture::restore() noexcept { return record(Opcodes::RESTORE); }
+
+Picture& Picture::reset() noexcept { return record(Opcodes::RESET); }
+
+Picture& Picture::setAntiAlias(const bool enabled) noexcept {
+  return record(Opcodes::SET_ANTI_ALIAS, enabled);
+}
+
+Picture& Picture::setStrokeColor(const Color& color) noexcept {
+  return record(Opcodes::SET_STROKE_COLOR, color);
+}
+
+Picture& Picture::setStrokePaint(const Paint& paint) noexcept {
+  return record(Opcodes::SET_STROKE_PAINT, toRecord(paint));
+}
+
+Picture& Picture::setFillColor(const Color& color) noexcept {
+  return record(Opcodes::SET_FILL_COLOR, color);
+}
+
+Picture& Picture::setFillPaint(const Paint& paint) noexcept {
+  return record(Opcodes::SET_FILL_PAINT, toRecord(paint));
+}
+
+Picture& Picture::setMiterLimit(const float limit) noexcept {
+  return record(Opcodes::SET_MITER_LIMIT, limit);
+}
+
+Picture& Picture::setStrokeWidth(const float size) noexcept {
+  return record(Opcodes::SET_STROKE_WIDTH, size);
+}
+
+Picture& Picture::setLineCap(const LineCap cap) noexcept {
+  return record(Opcodes::SET_LINE_CAP, cap);
+}
+
+Picture& Picture::setLineJoin(const LineJoin join) noexcept {
+  return record(Opcodes::SET_LINE_JOIN, join);
+}
+
+Picture& Picture::setGlobalAlpha(const unsigned char alpha) noexcept {
+  return record(Opcodes::SET_GLOBAL_ALPHA, alpha);
+}
+
+Picture& Picture::resetTransform() noexcept {
+  return record(Opcodes::RESET_TRANSFORM);
+}
+
+Picture& Picture::transform(const float horizontal_scaling,
+                            const float horizontal_skewing,
+                            const float vertical_skewing,
+                            const float vertical_scaling,
+                            const float horizontal_moving,
+                            const float vertical_moving) noexcept {
+  return transform({horizontal_scaling, horizontal_skewing, vertical_skewing,
+                    vertical_scaling, horizontal_moving, vertical_moving});
+}
+
+Picture& Picture::transform(const TransformMatrix& matrix) noexcept {
+  return record(Opcodes::TRANSFORM, matrix);
+}
+
+Picture& Picture::translate(const float x, const float y) noexcept {
+  return record(Opcodes::TRANSLATE, x, y);
+}
+
+Picture& Picture::rotate(const float angle) noexcept {
+  return record(Opcodes::ROTATE, angle);
+}
+
+Picture& Picture::skewX(const float angle) noexcept {
+  return record(Opcodes::SKEW_X, angle);
+}
+
+Picture& Picture::skewY(const float angle) noexcept {
+  return record(Opcodes::SKEW_Y, angle);
+}
+
+Picture& Picture::scale(const float x_percent, const float y_percent) noexcept {
+  return record(Opcodes::SCALE, x_percent, y_percent);
+}
+
+Picture& Picture::scissor(const float x, const float y, const float width,
+                          const float height) noexcept {
+  return record(Opcodes::SCISSOR, Rect{x, y, width, height});
+}
+
+Picture& Picture::intersectScissor(const float x, const float y,
+                                   const float width,
+                                   const float height) noexcept {
+  return record(Opcodes::INTERSECT_SCISSOR, Rect{x, y, width, height});
+}
+
+Picture& Picture::resetScissor() noexcept {
+  return record(Opcodes::RESET_SCISSOR);
+}
+
+Picture& Picture::beginPath() noexcept { return record(Opcodes::BEGIN_PATH); }
+
+Picture& Picture::moveTo(const float x, const float y) noexcept {
+  return record(Opcodes::MOVE_TO, x, y);
+}
+
+Picture& Picture::lineTo(const float x, const float y) noexcept {
+  return record(Opcodes::LINE_TO, x, y);
+}
+
+Picture& Picture::bezierTo(const float c1x, const float c1y, const float c2x,
+                           const float c2y, const float x,
+                           const float y) noexcept {
+  return record(Opcodes::BEZIER_TO, c1x, c1y, c2x, c2y, x, y);
+}
+
+Picture& Picture::quadTo(const float cx, const float cy, const float x,
+                         const float y) noexcept {
+  return record(Opcodes::QUAD_TO, cx, cy, x, y);
+}
+
+Picture& Picture::arcTo(const float x1, const float y1, const float x2,
+                        const float y2, const float radius) noexcept {
+  return record(Opcodes::ARC_TO, x1, y1, x2, y2, radius);
+}
+
+Picture& Picture::closePath() noexcept { return record(Opcodes::CLOSE_PATH); }
+
+Picture& Picture::setPathFillRule(const Solidity solidity) noexcept {
+  return record(Opcodes::SET_PATH_FILL_RULE, solidity);
+}
+
+Picture& Picture::arc(const float center_x, const float center_y,
+                      const float radius, const float start_angle,
+                      const float end_angle,
+                      const Direction direction) noexcept {
+  return record(Opcodes::ARC, center_x, center_y, radius, start_angle,
+                end_angle, direction);
+}
+
+Picture& Picture::rectangle(const float x, const float y, const float width,
+                            const float height) noexcept {
+  return record(Opcodes::RECTANGLE, Rect{x, y, width, height});
+}
+
+Picture& Picture::roundedRectangle(const float x, const float y,
+                                   const float width, const float height,
+                                   const float radius) noexcept {
+  return roundedRectangle(x, y, width, height, radius, radius, radius, radius);
+}
+
+Picture& Picture::roundedRectangle(
+    const float x, const float y, const float width, const float height,
+    const float radius_top_left, const float radius_top_right,
+    const float radius_bottom_right, const float radius_bottom_left) noexcept {
+  return record(Opcodes::ROUNDED_RECTANGLE, Rect{x, y, width, height},
+                radius_top_left, radius_top_right, radius_bottom_right,
+                radius_bottom_left);
+}
+
+Picture& Picture::ellipse(const float center_x, const float center_y,
+                          const float radius_x, const float radius_y) noexcept {
+  return record(Opcodes::ELLIPSE, center_x, center_y, radius_x, radius_y);
+}
+
+Picture& Picture::circle(const float center_x, const float center_y,
+                         const float radius) noexcept {
+  return record(Opcodes::CIRCLE, center_x, center_y, radius);
+}
+
+Picture& Picture::fill() noexcept { return record(Opcodes::FILL); }
+
+Picture& Picture::stroke() noexcept { return record(Opcodes::STROKE); }
+
+Picture& Picture::fill(const Path& path) noexcept {
+  return record(Opcodes::FILL_PATH, &path);
+}
+
+Picture& Picture::stroke(const Path& path) noexcept {
+  return record(Opcodes::STROKE_PATH, &path);
+}
+}  // namespace dana
@@ -0,0 +1,118 @@
+#include "dana/readback.h"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+
+namespace dana {
+
+struct Readback::Slot {
+  GLuint buffer{0};
+  GLsync fence{nullptr};
+  GLsizeiptr capacity{0};
+  FramePixels pixels;
+};
+
+// How long a single blocking wait on a fence lasts before it is retried
+static constexpr GLuint64 fence_timeout_ns{100000000};
+
+Readback::Readback(const std::size_t buffer_count,
+                   const ReadbackCallback& callback)
+    : m_slots(std::max<std::size_t>(buffer_count, 1)),
+      m_fences_supported{GLEW_VERSION_3_2 || GLEW_ARB_sync},
+      m_callback{callback} {
+  for (auto& slot : m_slots) {
+    glGenBuffers(1, &slot.buffer);
+  }
+}
+
+Readback::~Readback() noexcept {
+  for (auto& slot : m_slots) {
+    if (slot.fence != nullptr) {
+      glDeleteSync(slot.fence);
+    }
+    glDeleteBuffers(1, &slot.buffer);
+  }
+}
+
+void Readback::queue(const int x, const int y, const int width,
+                     const int height, const uint64_t frame) noexcept {
+  if (m_pending == m_slots.size()) {
+    deliverOldest(true);
+  }
+  auto& slot{m_slots[(m_oldest + m_pending) % m_slots.size()]};
+
+  const auto stride{width * 4};
+  const auto size{static_cast<GLsizeiptr>(stride) * height};
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+
+  if (slot.capacity < size) {
+    glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+    slot.capacity = size;
+  }
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+  glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  if (m_fences_supported) {
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+  slot.pixels = FramePixels{frame, width, height, stride, nullptr};
+  ++m_pending;
+}
+
+void Readback::poll() noexcept {
+  while (m_pending > 0 && deliverOldest(false)) {
+  }
+}
+
+void Readback::flush() noexcept {
+  while (m_pending > 0) {
+    deliverOldest(true);
+  }
+}
+
+std::size_t Readback::getPending() const noexcept { return m_pending; }
+
+bool Readback::deliverOldest(const bool wait) noexcept {
+  auto& slot{m_slots[m_oldest]};
+
+  if (slot.fence != nullptr) {
+    GLenum status{
+        glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0)};
+
+    while (wait && status == GL_TIMEOUT_EXPIRED) {
+      status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                fence_timeout_ns);
+    }
+    if (status == GL_TIMEOUT_EXPIRED) {
+      return false;
+    }
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+  } else if (!wait) {
+    // Without fences there is no way to tell if the GPU is done, so reads are
+    // only handed over once the ring is full and a wait is unavoidable.
+    return false;
+  }
+  const auto size{static_cast<GLsizeiptr>(slot.pixels.stride) *
+                  slot.pixels.height};
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+  const auto* data{static_cast<const unsigned char*>(
+      glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT))};
+
+  if (nullptr != data) {
+    slot.pixels.data = data;
+    m_callback(slot.pixels);
+    slot.pixels.data = nullptr;
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  m_oldest = (m_oldest + 1) % m_slots.size();
+  --m_pending;
+  return true;
+}
+}  // namespace dana
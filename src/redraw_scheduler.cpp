@@ -0,0 +1,86 @@
+#include "dana/redraw_scheduler.h"
+
+#include <utility>
+
+namespace dana {
+
+RedrawScheduler::RedrawScheduler(std::function<void()> wake_up) noexcept
+    : m_wake_up{std::move(wake_up)} {}
+
+void RedrawScheduler::setRedrawMode(const RedrawModes redraw_mode) noexcept {
+  m_redraw_mode = redraw_mode;
+}
+
+RedrawModes RedrawScheduler::getRedrawMode() const noexcept {
+  return m_redraw_mode;
+}
+
+void RedrawScheduler::setRedrawInterval(
+    const Clock::duration redraw_interval) noexcept {
+  m_redraw_interval = redraw_interval;
+}
+
+void RedrawScheduler::invalidate() noexcept {
+  m_invalidated = true;
+
+  // Wake up the event loop in case it is blocked waiting for events
+  if (m_wake_up) {
+    m_wake_up();
+  }
+}
+
+void RedrawScheduler::handleInputEvent() noexcept { requestFrame(); }
+
+void RedrawScheduler::requestFrame() noexcept { m_invalidated = true; }
+
+bool RedrawScheduler::handleWindowEvent(const WindowEvents event) noexcept {
+  switch (event) {
+    case WindowEvents::HIDDEN:
+    case WindowEvents::MINIMIZED:
+      m_visible = false;
+      return false;
+    case WindowEvents::SHOWN:
+    case WindowEvents::RESTORED:
+    case WindowEvents::MAXIMIZED:
+    case WindowEvents::EXPOSED:
+    case WindowEvents::RESIZED:
+    case WindowEvents::SIZE_CHANGED:
+      m_visible = true;
+      m_invalidated = true;
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool RedrawScheduler::isVisible() const noexcept { return m_visible; }
+
+void RedrawScheduler::frameRendered(const Clock::time_point time) noexcept {
+  m_invalidated = false;
+  m_last_frame_time = time;
+}
+
+bool RedrawScheduler::isFrameDue(const Clock::time_point now) const noexcept {
+  if (!m_visible) {
+    return false;
+  }
+  if (m_redraw_mode == RedrawModes::CONTINUOUS || m_invalidated) {
+    return true;
+  }
+  return m_redraw_interval.count() > 0 &&
+         now - m_last_frame_time >= m_redraw_interval;
+}
+
+int RedrawScheduler::getEventTimeout(const Clock::time_point now) const
+    noexcept {
+  if (isFrameDue(now)) {
+    return 0;
+  }
+  if (!m_visible || m_redraw_interval.count() <= 0) {
+    return -1;
+  }
+  const auto remaining{std::chrono::ceil<std::chrono::milliseconds>(
+      m_last_frame_time + m_redraw_interval - now)};
+  return static_cast<int>(remaining.count());
+}
+}  // namespace dana
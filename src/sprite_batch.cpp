@@ -0,0 +1,97 @@
+#include "dana/sprite_batch.h"
+
+namespace dana {
+
+static bool isSameColor(const Color& a, const Color& b) noexcept {
+  return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+SpriteBatch::SpriteBatch(const Image& image) noexcept {
+  const auto size{image.getTextureSize()};
+
+  m_image = image.getHandle().value_or(0);
+  m_region = image.getRegion();
+  m_inverse_width = size.first > 0 ? 1.0f / size.first : 0.0f;
+  m_inverse_height = size.second > 0 ? 1.0f / size.second : 0.0f;
+}
+
+SpriteBatch& SpriteBatch::clear() noexcept {
+  m_vertices.clear();
+  m_runs.clear();
+  return *this;
+}
+
+bool SpriteBatch::isEmpty() const noexcept {
+  return m_vertices.empty();
+}
+
+std::size_t SpriteBatch::getSpriteCount() const noexcept {
+  return m_vertices.size() / 6;
+}
+
+std::size_t SpriteBatch::getDrawCallCount() const noexcept {
+  return m_runs.size();
+}
+
+SpriteBatch& SpriteBatch::reserve(const std::size_t sprite_count) noexcept {
+  m_vertices.reserve(sprite_count * 6);
+  return *this;
+}
+
+SpriteBatch& SpriteBatch::add(const Rect& source, const Rect& destination,
+                              const Color& tint) noexcept {
+  const float left{destination.x};
+  const float top{destination.y};
+  const float right{destination.x + destination.width};
+  const float bottom{destination.y + destination.height};
+
+  addQuad(source,
+          {{left, top, 0, 0},
+           {right, top, 0, 0},
+           {right, bottom, 0, 0},
+           {left, bottom, 0, 0}},
+          tint);
+  return *this;
+}
+
+SpriteBatch& SpriteBatch::add(const Rect& source,
+                              const TransformMatrix& transform,
+                              const Color& tint) noexcept {
+  const auto apply = [&transform](const float x, const float y) {
+    return Vertex{
+        x * transform.horizontal_scaling + y * transform.vertical_skewing +
+            transform.horizontal_moving,
+        x * transform.horizontal_skewing + y * transform.vertical_scaling +
+            transform.vertical_moving,
+        0, 0};
+  };
+  addQuad(source,
+          {apply(0, 0), apply(source.width, 0),
+           apply(source.width, source.height), apply(0, source.height)},
+          tint);
+  return *this;
+}
+
+void SpriteBatch::addQuad(const Rect& source, const Vertex (&corners)[4],
+                          const Color& tint) noexcept {
+  const float x{m_region.x + source.x};
+  const float y{m_region.y + source.y};
+  const float u0{x * m_inverse_width};
+  const float v0{y * m_inverse_height};
+  const float u1{(x + source.width) * m_inverse_width};
+  const float v1{(y + source.height) * m_inverse_height};
+
+  const Vertex quad[4]{{corners[0].x, corners[0].y, u0, v0},
+                       {corners[1].x, corners[1].y, u1, v0},
+                       {corners[2].x, corners[2].y, u1, v1},
+                       {corners[3].x, corners[3].y, u0, v1}};
+
+  m_vertices.insert(m_vertices.end(),
+                    {quad[0], quad[1], quad[2], quad[0], quad[2], quad[3]});
+
+  if (m_runs.empty() || !isSameColor(m_runs.back().tint, tint)) {
+    m_runs.push_back({tint, 0});
+  }
+  m_runs.back().vertex_count += 6;
+}
+}  // namespace dana
@@ -0,0 +1,156 @@
+#include "dana/texture_atlas.h"
+
+#include <nanovg/nanovg.h>
+
+#include <algorithm>
+#include <climits>
+
+namespace dana {
+
+TextureAtlas::Page::~Page() noexcept {
+  nvgDeleteImage(context.get(), image);
+}
+
+TextureAtlas::TextureAtlas(const std::shared_ptr<NVGcontext>& context,
+                           const int page_size, const int padding,
+                           const int image_flags) noexcept
+    : m_context{context},
+      m_page_size{page_size},
+      m_padding{std::max(padding, 0)},
+      m_image_flags{image_flags &
+                    ~(NVG_IMAGE_GENERATE_MIPMAPS | NVG_IMAGE_REPEATX |
+                      NVG_IMAGE_REPEATY)} {}
+
+bool TextureAtlas::fits(const int width, const int height) const noexcept {
+  return width > 0 && height > 0 && width + 2 * m_padding <= m_page_size &&
+         height + 2 * m_padding <= m_page_size;
+}
+
+int TextureAtlas::getImageFlags() const noexcept {
+  return m_image_flags;
+}
+
+std::size_t TextureAtlas::getPageCount() const noexcept {
+  return m_pages.size();
+}
+
+Image TextureAtlas::add(const int width, const int height,
+                        const unsigned char* data) noexcept {
+  if (!fits(width, height) || data == nullptr) {
+    return Image();
+  }
+  const int padded_width{width + 2 * m_padding};
+  const int padded_height{height + 2 * m_padding};
+  std::shared_ptr<Page> page{nullptr};
+  int x{0};
+  int y{0};
+
+  for (auto& candidate : m_pages) {
+    // Only the atlas refers to the page, so all images on it are gone
+    if (candidate.use_count() == 1) {
+      candidate->skyline = {{0, 0, m_page_size}};
+    }
+    if (place(*candidate, padded_width, padded_height, x, y)) {
+      page = candidate;
+      break;
+    }
+  }
+  if (!page) {
+    const auto image{nvgCreateImageRGBA(m_context.get(), m_page_size,
+                                        m_page_size, m_image_flags, nullptr)};
+    if (image == 0) {
+      return Image();
+    }
+    page = std::make_shared<Page>();
+    page->context = m_context;
+    page->image = image;
+    page->skyline = {{0, 0, m_page_size}};
+    m_pages.push_back(page);
+    place(*page, padded_width, padded_height, x, y);
+  }
+  // Repeat the edge pixels into the border, so filtering at the edges of the
+  // image only blends in its own pixels
+  std::vector<unsigned char> pixels(
+      static_cast<std::size_t>(padded_width) * padded_height * 4);
+
+  for (int row = 0; row < padded_height; ++row) {
+    const int source_row{std::clamp(row - m_padding, 0, height - 1)};
+
+    for (int column = 0; column < padded_width; ++column) {
+      const int source_column{std::clamp(column - m_padding, 0, width - 1)};
+      std::copy_n(data + (source_row * width + source_column) * 4, 4,
+                  pixels.data() + (row * padded_width + column) * 4);
+    }
+  }
+  nvgUpdateImageRegion(m_context.get(), page->image, x, y, padded_width,
+                       padded_height, padded_width, pixels.data());
+
+  const Rect region{static_cast<float>(x + m_padding),
+                    static_cast<float>(y + m_padding),
+                    static_cast<float>(width), static_cast<float>(height)};
+  return Image(m_context, page->image, region, page);
+}
+
+bool TextureAtlas::place(Page& page, const int width, const int height,
+                         int& x, int& y) const noexcept {
+  auto& skyline{page.skyline};
+  auto best_index{skyline.size()};
+  int best_top{INT_MAX};
+  int best_width{INT_MAX};
+
+  // Find the shelf where the image ends lowest, preferring narrow shelves
+  for (std::size_t i = 0; i < skyline.size(); ++i) {
+    if (skyline[i].x + width > m_page_size) {
+      break;
+    }
+    int top{0};
+    int remaining{width};
+
+    for (auto j = i; remaining > 0; ++j) {
+      top = std::max(top, skyline[j].y);
+      remaining -= skyline[j].width;
+    }
+    if (top + height > m_page_size) {
+      continue;
+    }
+    if (top + height < best_top ||
+        (top + height == best_top && skyline[i].width < best_width)) {
+      best_index = i;
+      best_top = top + height;
+      best_width = skyline[i].width;
+    }
+  }
+  if (best_index == skyline.size()) {
+    return false;
+  }
+  x = skyline[best_index].x;
+  y = best_top - height;
+  skyline.insert(skyline.begin() + best_index, {x, best_top, width});
+
+  // Cut the shelves the image covers
+  for (auto i = best_index + 1; i < skyline.size();) {
+    const int overlap{x + width - skyline[i].x};
+
+    if (overlap <= 0) {
+      break;
+    }
+    skyline[i].x += overlap;
+    skyline[i].width -= overlap;
+
+    if (skyline[i].width > 0) {
+      break;
+    }
+    skyline.erase(skyline.begin() + i);
+  }
+  // Merge neighbouring shelves at the same height
+  for (std::size_t i = 0; i + 1 < skyline.size();) {
+    if (skyline[i].y == skyline[i + 1].y) {
+      skyline[i].width += skyline[i + 1].width;
+      skyline.erase(skyline.begin() + i + 1);
+    } else {
+      ++i;
+    }
+  }
+  return true;
+}
+}  // namespace dana
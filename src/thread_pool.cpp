@@ -0,0 +1,116 @@
+#include "dana/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace dana {
+
+ThreadPool::ThreadPool(const std::size_t thread_count) {
+  for (std::size_t i = 0; i < std::max<std::size_t>(thread_count, 1); ++i) {
+    m_workers.emplace_back([this] { work(); });
+  }
+}
+
+ThreadPool::~ThreadPool() noexcept {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_task_added.notify_all();
+
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+std::size_t ThreadPool::getDefaultThreadCount() noexcept {
+  return std::max(std::thread::hardware_concurrency(), 2u) - 1;
+}
+
+std::size_t ThreadPool::getThreadCount() const noexcept {
+  return m_workers.size();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tasks.push_back(std::move(task));
+  }
+  m_task_added.notify_one();
+}
+
+void ThreadPool::wait() noexcept {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_tasks_done.wait(lock,
+                    [this] { return m_tasks.empty() && m_busy_workers == 0; });
+}
+
+void ThreadPool::parallelFor(const std::size_t count,
+                             const std::function<void(std::size_t)>& task) {
+  if (count == 0) {
+    return;
+  }
+  // Shared with the helpers, so helpers that only start after the loop is
+  // done, for example behind long tasks in the queue, find no indices left
+  // and return without the caller waiting for them
+  struct Loop {
+    const std::function<void(std::size_t)>* task;
+    std::size_t count;
+    std::atomic<std::size_t> next_index{0};
+    std::size_t finished{0};
+    std::mutex mutex;
+    std::condition_variable all_finished;
+  };
+  const auto loop{std::make_shared<Loop>()};
+  loop->task = &task;
+  loop->count = count;
+
+  const auto run = [](Loop& state) {
+    for (auto i{state.next_index++}; i < state.count; i = state.next_index++) {
+      (*state.task)(i);
+
+      std::lock_guard<std::mutex> lock(state.mutex);
+
+      if (++state.finished == state.count) {
+        state.all_finished.notify_all();
+      }
+    }
+  };
+  // The calling thread takes part, so one helper less is needed
+  const auto helper_count{std::min(count, m_workers.size() + 1) - 1};
+
+  for (std::size_t i = 0; i < helper_count; ++i) {
+    submit([loop, run] { run(*loop); });
+  }
+  run(*loop);
+
+  // Only indices that were taken are waited for
+  std::unique_lock<std::mutex> lock(loop->mutex);
+  loop->all_finished.wait(lock, [&] { return loop->finished == count; });
+}
+
+void ThreadPool::work() noexcept {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_task_added.wait(lock,
+                        [this] { return m_stopping || !m_tasks.empty(); });
+
+      if (m_tasks.empty()) {
+        return;
+      }
+      task = std::move(m_tasks.front());
+      m_tasks.pop_front();
+      ++m_busy_workers;
+    }
+    task();
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      --m_busy_workers;
+    }
+    m_tasks_done.notify_all();
+  }
+}
+}  // namespace dana
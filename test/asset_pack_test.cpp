@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <dana/asset_pack.h>
+#include <dana/canvas.h>
+
+#include "test_util.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace dana;
+
+TEST(AssetPackTest, mapsPackedImages) {
+  const auto filename{testing::TempDir() + "dana_pack_images.pak"};
+  const unsigned char checker[16]{0,   0,   0,   255, 255, 255, 255, 255,
+                                  255, 255, 255, 255, 0,   0,   0,   255};
+  const unsigned char mask[3]{0, 128, 255};
+  {
+    AssetPackWriter writer;
+    AssetPackOptions alpha;
+    alpha.format = PixelFormat::ALPHA;
+    alpha.mipmaps = false;
+
+    writer.addImage("checker", 2, 2, checker).addImage("mask", 3, 1, mask,
+                                                       alpha);
+    ASSERT_TRUE(writer.write(filename));
+  }
+  AssetPack pack(filename);
+
+  ASSERT_TRUE(pack.isOpen());
+  ASSERT_EQ(pack.getImageNames(),
+            std::vector<std::string>({"checker", "mask"}));
+  ASSERT_EQ(pack.find("missing"), nullptr);
+
+  const auto* image{pack.find("checker")};
+
+  ASSERT_NE(image, nullptr);
+  ASSERT_EQ(image->format, PixelFormat::RGBA);
+  ASSERT_EQ(image->width, 2);
+  ASSERT_EQ(image->height, 2);
+  ASSERT_EQ(image->image_flags, IMAGE_GENERATE_MIPMAPS);
+  ASSERT_EQ(image->levels.size(), 2u);
+  ASSERT_EQ(std::vector<unsigned char>(image->levels[0], image->levels[0] + 16),
+            std::vector<unsigned char>(checker, checker + 16));
+  ASSERT_EQ(std::vector<unsigned char>(image->levels[1], image->levels[1] + 4),
+            std::vector<unsigned char>({128, 128, 128, 255}));
+
+  // Pixels start at page boundaries of the mapping
+  ASSERT_EQ(reinterpret_cast<std::uintptr_t>(image->levels[0]) %
+                AssetPack::page_size,
+            0u);
+
+  const auto* alpha_image{pack.find("mask")};
+
+  ASSERT_NE(alpha_image, nullptr);
+  ASSERT_EQ(alpha_image->format, PixelFormat::ALPHA);
+  ASSERT_EQ(alpha_image->levels.size(), 1u);
+  ASSERT_EQ(alpha_image->levels[0][1], 128);
+}
+
+TEST(AssetPackTest, rejectsInvalidFiles) {
+  const auto filename{testing::TempDir() + "dana_pack_invalid.pak"};
+  {
+    std::ofstream file(filename, std::ios::binary);
+    file << "DANAPACK but not really";
+  }
+  ASSERT_FALSE(AssetPack(filename).isOpen());
+  ASSERT_FALSE(AssetPack(testing::TempDir() + "missing.pak").isOpen());
+}
+
+TEST(AssetPackTest, drawsPackedImagesWithMipLevels) {
+  const auto filename{testing::TempDir() + "dana_pack_draw.pak"};
+  {
+    AssetPackWriter writer;
+    AssetPackOptions alpha;
+    alpha.format = PixelFormat::ALPHA;
+
+    const auto red{createPixels(16, 16, {255, 0, 0, 255})};
+    const std::vector<unsigned char> mask(16 * 16, 255);
+    writer.addImage("red", 16, 16, red.data())
+        .addImage("mask", 16, 16, mask.data(), alpha);
+    ASSERT_TRUE(writer.write(filename));
+  }
+  const AssetPack pack(filename);
+  Image red;
+  Image mask;
+  std::vector<Color> colors;
+
+  Canvas canvas(16, 8, headless);
+  canvas.setClearColor({0, 0, 0, 255})
+      .onNewFrame([&](Pencil& pencil) {
+        red = pencil.createImage(pack, "red");
+        mask = pencil.createImage(pack, "mask");
+
+        ASSERT_EQ(red.getSize(), std::make_pair(16, 16));
+        ASSERT_FALSE(pencil.createImage(pack, "missing").getHandle());
+
+        // Minified, so the packed mip levels are sampled
+        pencil.beginPath()
+            .rectangle(0, 0, 4, 4)
+            .setFillPaint(pencil.createImagePattern(red, 0, 0, 4, 4, 0, 255))
+            .fill();
+        pencil.beginPath()
+            .rectangle(8, 0, 8, 8)
+            .setFillPaint(
+                pencil.createImagePattern(mask, 8, 0, 8, 8, 0, 255))
+            .fill();
+      })
+      .onFrameReadback([&](const FramePixels& pixels) {
+        colors = {getPixel(pixels, 1, 1), getPixel(pixels, 12, 4)};
+      });
+
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(colors.size(), 2u);
+  EXPECT_EQ(colors[0].r, 255);
+  EXPECT_EQ(colors[0].g, 0);
+  EXPECT_EQ(colors[1].r, 255);
+  EXPECT_EQ(colors[1].g, 255);
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <dana/canvas.h>
+
+#include <vector>
+
+using namespace dana;
+
+TEST(CanvasTest, headlessRenderFrame) {
+  Canvas canvas(64, 32, headless);
+  int frames{0};
+
+  canvas.onNewFrame([&](Pencil& pencil) {
+    pencil.beginPath().rectangle(0, 0, 10, 10).fill();
+    ++frames;
+  });
+  canvas.renderFrame();
+  canvas.renderFrame();
+
+  ASSERT_TRUE(canvas.isHeadless());
+  ASSERT_EQ(frames, 2);
+  ASSERT_EQ(canvas.getFrameStatistics().getSummary(FramePhases::TOTAL).samples,
+            2u);
+}
+
+TEST(CanvasTest, headlessReadback) {
+  Canvas canvas(16, 8, headless);
+  std::vector<uint64_t> frames;
+  Color pixel;
+
+  canvas.setClearColor({10, 20, 30, 255})
+      .onFrameReadback([&](const FramePixels& pixels) {
+        frames.push_back(pixels.frame);
+        ASSERT_EQ(pixels.width, 16);
+        ASSERT_EQ(pixels.height, 8);
+        ASSERT_EQ(pixels.stride, 64);
+        pixel = {pixels.data[0], pixels.data[1], pixels.data[2],
+                 pixels.data[3]};
+      });
+
+  for (int i = 0; i < 5; ++i) {
+    canvas.renderFrame();
+  }
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(frames, (std::vector<uint64_t>{0, 1, 2, 3, 4}));
+  ASSERT_EQ(pixel.r, 10);
+  ASSERT_EQ(pixel.g, 20);
+  ASSERT_EQ(pixel.b, 30);
+  ASSERT_EQ(pixel.a, 255);
+}
+
+TEST(CanvasTest, partialRedraw) {
+  Canvas canvas(16, 16, headless);
+  Color fill_color{255, 0, 0, 255};
+  Color top_left;
+  Color bottom_right;
+  int frames{0};
+
+  canvas.setPartialRedraw(true)
+      .onNewFrame([&](Pencil& pencil) {
+        pencil.beginPath()
+            .rectangle(0, 0, 16, 16)
+            .setFillColor(fill_color)
+            .fill();
+        ++frames;
+      })
+      .onFrameReadback([&](const FramePixels& pixels) {
+        // Rows are stored bottom to top
+        const auto* top{pixels.data + 15 * pixels.stride};
+        const auto* bottom{pixels.data + 15 * 4};
+        top_left = {top[0], top[1], top[2], top[3]};
+        bottom_right = {bottom[0], bottom[1], bottom[2], bottom[3]};
+      });
+
+  canvas.renderFrame();
+  fill_color = {0, 0, 255, 255};
+  canvas.invalidate(Rect{0, 0, 4, 4});
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(canvas.getRedrawArea().width, 4);
+  ASSERT_EQ(top_left.b, 255);
+  ASSERT_EQ(bottom_right.r, 255);
+  ASSERT_EQ(bottom_right.b, 0);
+
+  // Frames without damage keep the previous content and skip drawing
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(frames, 2);
+  ASSERT_EQ(top_left.b, 255);
+  ASSERT_EQ(bottom_right.r, 255);
+}
+
+TEST(CanvasTest, parallelFrameMatchesSerial) {
+  Canvas canvas(32, 32, headless);
+  constexpr std::size_t chunks{8};
+  bool parallel{false};
+  std::vector<unsigned char> frames[2];
+
+  // Overlapping translucent rectangles, so the result depends on draw order
+  const auto drawChunk = [](auto& pencil, const std::size_t chunk) {
+    const auto offset{static_cast<float>(chunk * 3)};
+    pencil.beginPath()
+        .rectangle(offset, offset, 10, 10)
+        .setFillColor({static_cast<unsigned char>(chunk * 30), 128, 0, 128})
+        .fill();
+  };
+
+  canvas.setClearColor({0, 0, 0, 255})
+      .onNewFrame([&](Pencil& pencil) {
+        if (!parallel) {
+          for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+            drawChunk(pencil, chunk);
+          }
+        }
+      })
+      .onFrameReadback([&](const FramePixels& pixels) {
+        frames[parallel ? 1 : 0].assign(
+            pixels.data, pixels.data + pixels.height * pixels.stride);
+      });
+
+  canvas.renderFrame();
+  parallel = true;
+  canvas.onParallelFrame(chunks, [&](Picture& picture,
+                                     const std::size_t chunk) {
+    drawChunk(picture, chunk);
+  });
+  canvas.renderFrame();
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(frames[0], frames[1]);
+}
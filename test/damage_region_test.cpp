@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <dana/damage_region.h>
+
+using namespace dana;
+
+static constexpr Rect area{0, 0, 100, 50};
+
+TEST(DamageRegionTest, emptyByDefault) {
+  DamageRegion damage;
+
+  damage.add({10, 10, 0, 5});
+
+  ASSERT_TRUE(damage.isEmpty());
+  ASSERT_EQ(damage.getBounds(area).width, 0);
+  ASSERT_EQ(damage.getBounds(area).height, 0);
+}
+
+TEST(DamageRegionTest, mergesIntoBoundingBox) {
+  DamageRegion damage;
+
+  damage.add({10, 10, 5, 5});
+  damage.add({30, 20, 10, 10});
+
+  const auto bounds{damage.getBounds(area)};
+
+  ASSERT_FALSE(damage.isEmpty());
+  ASSERT_EQ(bounds.x, 10);
+  ASSERT_EQ(bounds.y, 10);
+  ASSERT_EQ(bounds.width, 30);
+  ASSERT_EQ(bounds.height, 20);
+}
+
+TEST(DamageRegionTest, clipsToArea) {
+  DamageRegion damage;
+
+  damage.add({90, -10, 20, 20});
+
+  const auto bounds{damage.getBounds(area)};
+
+  ASSERT_EQ(bounds.x, 90);
+  ASSERT_EQ(bounds.y, 0);
+  ASSERT_EQ(bounds.width, 10);
+  ASSERT_EQ(bounds.height, 10);
+}
+
+TEST(DamageRegionTest, full) {
+  DamageRegion damage;
+
+  damage.add({10, 10, 5, 5});
+  damage.addAll();
+
+  ASSERT_TRUE(damage.isFull());
+  ASSERT_EQ(damage.getBounds(area).width, 100);
+
+  damage.clear();
+
+  ASSERT_TRUE(damage.isEmpty());
+  ASSERT_FALSE(damage.isFull());
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <dana/canvas.h>
+#include <dana/device.h>
+
+#include <memory>
+
+using namespace dana;
+
+TEST(DeviceTest, canvasesSharePencil) {
+  const auto device{std::make_shared<Device>(headless)};
+  Canvas first(device, 8, 8, headless);
+  Canvas second(device, 16, 16, headless);
+  Pencil* first_pencil{nullptr};
+  Pencil* second_pencil{nullptr};
+
+  first.onNewFrame([&](Pencil& pencil) { first_pencil = &pencil; });
+  second.onNewFrame([&](Pencil& pencil) { second_pencil = &pencil; });
+  first.renderFrame();
+  second.renderFrame();
+
+  ASSERT_EQ(&first.getDevice(), device.get());
+  ASSERT_EQ(first_pencil, &device->getPencil());
+  ASSERT_EQ(second_pencil, &device->getPencil());
+}
+
+TEST(DeviceTest, canvasesRenderSeparately) {
+  const auto device{std::make_shared<Device>(headless)};
+  Canvas first(device, 8, 8, headless);
+  Color first_pixel;
+  Color second_pixel;
+  {
+    Canvas second(device, 16, 16, headless);
+
+    first.setClearColor({255, 0, 0, 255})
+        .onFrameReadback([&](const FramePixels& pixels) {
+          first_pixel = {pixels.data[0], pixels.data[1], pixels.data[2],
+                         pixels.data[3]};
+        });
+    second.setClearColor({0, 0, 255, 255})
+        .onFrameReadback([&](const FramePixels& pixels) {
+          second_pixel = {pixels.data[0], pixels.data[1], pixels.data[2],
+                          pixels.data[3]};
+        });
+    first.renderFrame();
+    second.renderFrame();
+    second.flushReadbacks();
+  }
+  // The remaining canvas keeps rendering after the other one is destroyed
+  first.renderFrame();
+  first.flushReadbacks();
+
+  ASSERT_EQ(first_pixel.r, 255);
+  ASSERT_EQ(first_pixel.b, 0);
+  ASSERT_EQ(second_pixel.r, 0);
+  ASSERT_EQ(second_pixel.b, 255);
+  ASSERT_EQ(first.getFrameCount(), 2u);
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include <dana/fixed_timestep.h>
+
+using namespace dana;
+using namespace std::chrono;
+
+TEST(FixedTimestepTest, firstAdvanceStartsClock) {
+  FixedTimestep timestep(100.0);
+  const FixedTimestep::Clock::time_point start{};
+
+  ASSERT_EQ(timestep.advance(start + seconds{1}), 0u);
+  ASSERT_EQ(timestep.getAlpha(), 0.0f);
+  ASSERT_NEAR(timestep.getStepSeconds(), 0.01f, 1e-6f);
+}
+
+TEST(FixedTimestepTest, accumulatesPartialSteps) {
+  FixedTimestep timestep(100.0);
+  const FixedTimestep::Clock::time_point start{};
+
+  timestep.advance(start);
+
+  ASSERT_EQ(timestep.advance(start + milliseconds{4}), 0u);
+  ASSERT_NEAR(timestep.getAlpha(), 0.4f, 1e-4f);
+  ASSERT_EQ(timestep.advance(start + milliseconds{25}), 2u);
+  ASSERT_NEAR(timestep.getAlpha(), 0.5f, 1e-4f);
+}
+
+TEST(FixedTimestepTest, capsSteps) {
+  FixedTimestep timestep(100.0);
+  const FixedTimestep::Clock::time_point start{};
+
+  timestep.setMaxSteps(3);
+  timestep.advance(start);
+
+  ASSERT_EQ(timestep.advance(start + milliseconds{105}), 3u);
+  ASSERT_EQ(timestep.getSkippedSteps(), 7u);
+  ASSERT_NEAR(timestep.getAlpha(), 0.5f, 1e-4f);
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <dana/frame_exporter.h>
+#include <nanovg/stb_image.h>
+
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+using namespace dana;
+
+// A 2x2 frame stored bottom to top: the bottom row is red and blue, the top
+// row is green and white.
+static const std::vector<unsigned char> pixels{
+    255, 0,   0,   255, 0,   0,   255, 255,
+    0,   255, 0,   255, 255, 255, 255, 255};
+
+static FramePixels createFrame(const uint64_t frame) {
+  return FramePixels{frame, 2, 2, 8, pixels.data()};
+}
+
+static std::string getTempPath(const std::string& name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static std::vector<unsigned char> readFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file),
+          std::istreambuf_iterator<char>()};
+}
+
+TEST(FrameExporterTest, raw) {
+  const auto path{getTempPath("dana_frame_exporter_test.rgba")};
+  {
+    FrameExporter exporter(path, FrameFormats::RAW_RGBA);
+    exporter.submit(createFrame(0));
+    exporter.submit(createFrame(1));
+    exporter.wait();
+
+    ASSERT_EQ(exporter.getEncodedFrames(), 2u);
+    ASSERT_EQ(exporter.getDroppedFrames(), 0u);
+  }
+  const auto data{readFile(path)};
+
+  ASSERT_EQ(data.size(), 32u);
+  ASSERT_EQ(std::vector<unsigned char>(data.begin(), data.begin() + 8),
+            std::vector<unsigned char>(pixels.begin() + 8, pixels.end()));
+  ASSERT_EQ(std::vector<unsigned char>(data.begin() + 8, data.begin() + 16),
+            std::vector<unsigned char>(pixels.begin(), pixels.begin() + 8));
+  std::filesystem::remove(path);
+}
+
+TEST(FrameExporterTest, y4m) {
+  const auto path{getTempPath("dana_frame_exporter_test.y4m")};
+  {
+    FrameExporter exporter(path, FrameFormats::Y4M);
+    exporter.setFrameRate(30);
+    exporter.submit(createFrame(0));
+    exporter.submit(createFrame(1));
+  }
+  const auto data{readFile(path)};
+  const std::string header{"YUV4MPEG2 W2 H2 F30:1 Ip A1:1 C444\n"};
+
+  ASSERT_EQ(std::string(data.begin(), data.begin() + header.size()), header);
+  ASSERT_EQ(data.size(), header.size() + 2 * (6 + 3 * 4));
+  // White luma in limited range
+  ASSERT_EQ(data[header.size() + 6 + 1], 235);
+  std::filesystem::remove(path);
+}
+
+TEST(FrameExporterTest, png) {
+  const auto prefix{getTempPath("dana_frame_exporter_test_")};
+  {
+    FrameExporter exporter(prefix, FrameFormats::PNG);
+    exporter.submit(createFrame(7));
+  }
+  const auto path{prefix + "000007.png"};
+  int width{0};
+  int height{0};
+  int channels{0};
+  auto* decoded{stbi_load(path.c_str(), &width, &height, &channels, 4)};
+
+  ASSERT_NE(decoded, nullptr);
+  ASSERT_EQ(width, 2);
+  ASSERT_EQ(height, 2);
+  ASSERT_EQ(std::vector<unsigned char>(decoded, decoded + 8),
+            std::vector<unsigned char>(pixels.begin() + 8, pixels.end()));
+  stbi_image_free(decoded);
+  std::filesystem::remove(path);
+}
+
+#ifndef _WIN32
+TEST(FrameExporterTest, dropWhenFull) {
+  const auto path{getTempPath("dana_frame_exporter_drop_test.fifo")};
+  constexpr uint64_t frames{20};
+  constexpr int size{256};
+
+  // The exporter writes into a pipe that is not read until all frames are
+  // submitted. A frame is larger than the pipe buffer, so the worker stalls
+  // on the first one and the queue stays full.
+  std::filesystem::remove(path);
+  ASSERT_EQ(mkfifo(path.c_str(), 0600), 0);
+
+  std::promise<void> submitted;
+  std::size_t bytes_read{0};
+  uint64_t encoded_frames{0};
+  std::thread reader([&, released = submitted.get_future()] {
+    std::ifstream pipe(path, std::ios::binary);
+    released.wait();
+    bytes_read = std::vector<unsigned char>(
+                     std::istreambuf_iterator<char>(pipe),
+                     std::istreambuf_iterator<char>())
+                     .size();
+  });
+  const std::vector<unsigned char> large(size * size * 4, 128);
+  {
+    FrameExporter exporter(path, FrameFormats::RAW_RGBA, QueuePolicies::DROP,
+                           1);
+    for (uint64_t frame = 0; frame < frames; ++frame) {
+      exporter.submit(FramePixels{frame, size, size, size * 4, large.data()});
+    }
+    const auto dropped{exporter.getDroppedFrames()};
+    const auto encoded{exporter.getEncodedFrames()};
+
+    submitted.set_value();
+    exporter.wait();
+
+    EXPECT_GE(dropped, frames - 2);
+    EXPECT_EQ(encoded, 0u);
+    EXPECT_EQ(exporter.getEncodedFrames() + exporter.getDroppedFrames(),
+              frames);
+    EXPECT_LT(exporter.getEncodedFrames(), frames);
+    encoded_frames = exporter.getEncodedFrames();
+  }
+  reader.join();
+
+  EXPECT_EQ(bytes_read, encoded_frames * size * size * 4);
+  std::filesystem::remove(path);
+}
+#endif
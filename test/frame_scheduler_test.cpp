@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+
+#include <dana/frame_scheduler.h>
+
+#include <thread>
+
+using namespace dana;
+
+TEST(FrameSchedulerTest, uncappedByDefault) {
+  FrameScheduler scheduler;
+
+  ASSERT_TRUE(scheduler.isUncapped());
+  ASSERT_EQ(scheduler.getTargetFrameRate(), 0.0);
+}
+
+TEST(FrameSchedulerTest, targetFrameRate) {
+  FrameScheduler scheduler;
+
+  scheduler.setTargetFrameRate(50.0);
+
+  ASSERT_FALSE(scheduler.isUncapped());
+  ASSERT_NEAR(scheduler.getTargetFrameRate(), 50.0, 0.001);
+}
+
+TEST(FrameSchedulerTest, waitsForDeadlines) {
+  FrameScheduler scheduler;
+  scheduler.setTargetFrameRate(200.0);
+
+  const auto begin_time{FrameScheduler::Clock::now()};
+
+  for (int i = 0; i < 4; ++i) {
+    scheduler.waitForNextFrame();
+  }
+
+  ASSERT_GE(FrameScheduler::Clock::now() - begin_time,
+            std::chrono::milliseconds(20));
+}
+
+TEST(FrameSchedulerTest, reanchorsAfterOverrun) {
+  FrameScheduler scheduler;
+  scheduler.setTargetFrameRate(100.0);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  const auto overrun_time{FrameScheduler::Clock::now()};
+  scheduler.waitForNextFrame();
+
+  ASSERT_GT(scheduler.getDeadline(), overrun_time);
+}
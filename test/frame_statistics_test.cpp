@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include <dana/frame_statistics.h>
+
+using namespace dana;
+using std::chrono::microseconds;
+using std::chrono::nanoseconds;
+
+TEST(FrameStatisticsTest, emptySummary) {
+  const FrameStatistics statistics;
+  const auto summary{statistics.getSummary(FramePhases::TOTAL)};
+
+  ASSERT_EQ(summary.samples, 0u);
+  ASSERT_EQ(summary.max, nanoseconds{0});
+  ASSERT_EQ(statistics.getLast(FramePhases::TOTAL), nanoseconds{0});
+}
+
+TEST(FrameStatisticsTest, summary) {
+  FrameStatistics statistics(100);
+
+  for (int i = 100; i >= 1; --i) {
+    statistics.record(FramePhases::DRAW, microseconds{i});
+  }
+  const auto summary{statistics.getSummary(FramePhases::DRAW)};
+
+  ASSERT_EQ(summary.samples, 100u);
+  ASSERT_EQ(summary.min, microseconds{1});
+  ASSERT_EQ(summary.max, microseconds{100});
+  ASSERT_EQ(summary.mean, nanoseconds{50500});
+  ASSERT_EQ(summary.p50, microseconds{50});
+  ASSERT_EQ(summary.p95, microseconds{95});
+  ASSERT_EQ(summary.p99, microseconds{99});
+  ASSERT_EQ(statistics.getLast(FramePhases::DRAW), microseconds{1});
+}
+
+TEST(FrameStatisticsTest, rollingWindow) {
+  FrameStatistics statistics(4);
+
+  for (int i = 1; i <= 10; ++i) {
+    statistics.record(FramePhases::SWAP, microseconds{i});
+  }
+  const auto summary{statistics.getSummary(FramePhases::SWAP)};
+
+  ASSERT_EQ(summary.samples, 4u);
+  ASSERT_EQ(summary.min, microseconds{7});
+  ASSERT_EQ(summary.max, microseconds{10});
+  ASSERT_EQ(statistics.getLast(FramePhases::SWAP), microseconds{10});
+  ASSERT_EQ(statistics.getSummary(FramePhases::DRAW).samples, 0u);
+}
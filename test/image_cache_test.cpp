@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <dana/asset_pack.h>
+#include <dana/canvas.h>
+#include <dana/image_cache.h>
+
+#include "test_util.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace dana;
+
+// The images written by writeImageFile are 4x4 and take 64 bytes as a texture
+TEST(ImageCacheTest, sharesImagesByKey) {
+  Canvas canvas(8, 8, headless);
+  const auto filename{writeImageFile("dana_cache_shared.ppm")};
+  std::unique_ptr<ImageCache> cache;
+
+  canvas.onNewFrame([&](Pencil& pencil) {
+    cache = std::make_unique<ImageCache>(pencil);
+
+    const auto first{cache->get(filename, 0)};
+    const auto second{cache->get(filename, 0)};
+    const auto mipmapped{cache->get(filename, IMAGE_GENERATE_MIPMAPS)};
+
+    ASSERT_EQ(first.get().getHandle(), second.get().getHandle());
+    ASSERT_NE(first.get().getHandle(), mipmapped.get().getHandle());
+    ASSERT_EQ(cache->getImageCount(), 2u);
+    ASSERT_EQ(cache->getMissCount(), 2u);
+    ASSERT_EQ(cache->getHitCount(), 5u);
+    ASSERT_EQ(cache->getResidentBytes(), 64u + 64u + 64u / 3);
+  });
+
+  canvas.renderFrame();
+}
+
+TEST(ImageCacheTest, countsChannelsAndMipLevelsOfLoadedImages) {
+  Canvas canvas(8, 8, headless);
+  const auto filename{testing::TempDir() + "dana_cache_formats.pak"};
+  const auto pixels{createPixels(8, 8, {255, 255, 255, 255})};
+  const std::vector<unsigned char> coverage(8 * 8, 255);
+  {
+    AssetPackWriter writer;
+    AssetPackOptions alpha;
+    alpha.format = PixelFormat::ALPHA;
+
+    writer.addImage("mask", 8, 8, coverage.data(), alpha);
+    ASSERT_TRUE(writer.write(filename));
+  }
+  AssetPack pack(filename);
+  std::unique_ptr<ImageCache> cache;
+
+  canvas.onNewFrame([&](Pencil& pencil) {
+    cache = std::make_unique<ImageCache>(pencil);
+
+    // Loaded by key, so the cache only learns about the format and the mip
+    // levels from the textures
+    const auto mask{cache->get("mask", [&](Pencil& loader) {
+      return loader.createImage(pack, "mask");
+    })};
+    ASSERT_TRUE(mask.isResident());
+    ASSERT_EQ(cache->getResidentBytes(), 64u + 64u / 3);
+
+    const auto mipmapped{cache->get("mipmapped", [&](Pencil& loader) {
+      return loader.createImage(8, 8, pixels.data(), IMAGE_GENERATE_MIPMAPS);
+    })};
+    ASSERT_TRUE(mipmapped.isResident());
+    ASSERT_EQ(cache->getResidentBytes(), 64u + 64u / 3 + 256u + 256u / 3);
+  });
+
+  canvas.renderFrame();
+}
+
+TEST(ImageCacheTest, evictsLeastRecentlyDrawnImages) {
+  Canvas canvas(8, 8, headless);
+  const auto filename_a{writeImageFile("dana_cache_a.ppm")};
+  const auto filename_b{writeImageFile("dana_cache_b.ppm")};
+  const auto filename_c{writeImageFile("dana_cache_c.ppm")};
+  std::unique_ptr<ImageCache> cache;
+  CachedImage a, b, c;
+  int frame{0};
+
+  canvas.onNewFrame([&](Pencil& pencil) {
+    switch (++frame) {
+      case 1:
+        cache = std::make_unique<ImageCache>(pencil, 128);
+        a = cache->get(filename_a, 0);
+        b = cache->get(filename_b, 0);
+        break;
+      case 2:
+        a.get();
+        c = cache->get(filename_c, 0);
+
+        // B was drawn least recently
+        ASSERT_TRUE(a.isResident());
+        ASSERT_FALSE(b.isResident());
+        ASSERT_TRUE(c.isResident());
+        ASSERT_EQ(cache->getEvictionCount(), 1u);
+        ASSERT_EQ(cache->getResidentBytes(), 128u);
+        break;
+      case 3:
+        // Drawing an evicted image loads it again
+        ASSERT_TRUE(b.get().getHandle());
+        ASSERT_TRUE(b.isResident());
+        ASSERT_FALSE(a.isResident());
+        ASSERT_EQ(cache->getMissCount(), 4u);
+        ASSERT_EQ(cache->getEvictionCount(), 2u);
+        break;
+    }
+  });
+
+  for (int i = 0; i < 3; ++i) {
+    canvas.renderFrame();
+  }
+  ASSERT_EQ(frame, 3);
+}
+
+TEST(ImageCacheTest, keepsImagesDrawnInTheCurrentFrame) {
+  Canvas canvas(8, 8, headless);
+  const auto filename_a{writeImageFile("dana_cache_frame_a.ppm")};
+  const auto filename_b{writeImageFile("dana_cache_frame_b.ppm")};
+  std::unique_ptr<ImageCache> cache;
+  CachedImage a, b;
+  int frame{0};
+
+  canvas.onNewFrame([&](Pencil& pencil) {
+    if (++frame == 1) {
+      cache = std::make_unique<ImageCache>(pencil, 64);
+      a = cache->get(filename_a, 0);
+      b = cache->get(filename_b, 0);
+
+      // Both are needed for this frame, so the budget is exceeded
+      ASSERT_TRUE(a.isResident());
+      ASSERT_TRUE(b.isResident());
+      ASSERT_EQ(cache->getResidentBytes(), 128u);
+    } else {
+      b.get();
+      ASSERT_FALSE(a.isResident());
+      ASSERT_EQ(cache->getResidentBytes(), 64u);
+    }
+  });
+
+  canvas.renderFrame();
+  canvas.renderFrame();
+  ASSERT_EQ(frame, 2);
+}
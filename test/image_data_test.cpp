@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <dana/canvas.h>
+#include <dana/image_data.h>
+
+#include "test_util.h"
+
+#include <vector>
+
+using namespace dana;
+
+TEST(ImageDataTest, tracksDirtyRectangles) {
+  ImageData image_data(32, 16);
+
+  ASSERT_EQ(image_data.getDirtyBytes(), 32u * 16 * 4);
+  image_data.clearDirty();
+  ASSERT_FALSE(image_data.isDirty());
+
+  image_data.setPixel(1, 1, {255, 0, 0, 255})
+      .setPixel(2, 1, {255, 0, 0, 255})
+      .fill({20.5f, 8, 4, 20}, {0, 255, 0, 255});
+
+  // Adjacent pixels are merged, and rectangles are rounded out and clipped
+  const auto& rects{image_data.getDirtyRects()};
+
+  ASSERT_EQ(rects.size(), 2u);
+  ASSERT_EQ(rects[0].x, 1);
+  ASSERT_EQ(rects[0].width, 2);
+  ASSERT_EQ(rects[1].x, 20);
+  ASSERT_EQ(rects[1].width, 5);
+  ASSERT_EQ(rects[1].height, 8);
+  ASSERT_EQ(image_data.getDirtyBytes(), (2u + 5 * 8) * 4);
+  ASSERT_EQ(image_data.getPixel(24, 15).g, 255);
+
+  // Too many rectangles are merged into their bounding box
+  image_data.clearDirty();
+
+  for (int i = 0; i <= static_cast<int>(ImageData::max_dirty_rects); ++i) {
+    image_data.setPixel(i * 3, i, {0, 0, 255, 255});
+  }
+  ASSERT_EQ(rects.size(), 1u);
+  ASSERT_EQ(rects[0].width, ImageData::max_dirty_rects * 3 + 1);
+}
+
+TEST(ImageDataTest, uploadsChangedPixels) {
+  // Large enough for whole uploads to be streamed through a pixel buffer
+  constexpr int width{256};
+  constexpr int height{128};
+  ImageData image_data(width, height);
+  Image image;
+  int frame{0};
+  std::vector<Color> colors;
+
+  image_data.fill({0, 0, width, height}, {255, 0, 0, 255});
+
+  Canvas canvas(width, height, headless);
+  canvas.setClearColor({0, 0, 0, 255})
+      .onNewFrame([&](Pencil& pencil) {
+        if (++frame == 1) {
+          image = pencil.createImage(image_data, IMAGE_NEAREST);
+          ASSERT_FALSE(image_data.isDirty());
+        } else {
+          // Changed without being marked dirty, so it is not uploaded
+          image_data.getPixels()[0] = 0;
+
+          // The lower half is streamed, and the blue pixels are uploaded
+          // directly
+          const unsigned char blue[8]{0, 0, 255, 255, 0, 0, 255, 255};
+          image_data.fill({0, height / 2, width, height / 2}, {255, 0, 0, 255})
+              .setPixel(width - 1, height - 1, {0, 255, 0, 255})
+              .putPixels(100, 50, 2, 1, 2, blue);
+          pencil.putImageData(image, image_data);
+          ASSERT_FALSE(image_data.isDirty());
+        }
+        pencil.beginPath()
+            .rectangle(0, 0, width, height)
+            .setFillPaint(pencil.createImagePattern(image, 0, 0, width,
+                                                    height, 0, 255))
+            .fill();
+      })
+      .onFrameReadback([&](const FramePixels& pixels) {
+        colors = {getPixel(pixels, 0, 0),
+                  getPixel(pixels, width - 1, height - 1),
+                  getPixel(pixels, 101, 50), getPixel(pixels, 102, 50)};
+      });
+
+  canvas.renderFrame();
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(colors.size(), 4u);
+
+  const std::vector<Color> expected{{255, 0, 0, 255},
+                                    {0, 255, 0, 255},
+                                    {0, 0, 255, 255},
+                                    {255, 0, 0, 255}};
+
+  for (std::size_t i = 0; i < colors.size(); ++i) {
+    EXPECT_EQ(colors[i].r, expected[i].r) << "pixel " << i;
+    EXPECT_EQ(colors[i].g, expected[i].g) << "pixel " << i;
+    EXPECT_EQ(colors[i].b, expected[i].b) << "pixel " << i;
+  }
+}
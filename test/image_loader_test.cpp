@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <dana/canvas.h>
+#include <dana/device.h>
+#include <dana/image_loader.h>
+
+#include "test_util.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dana;
+
+// Writes an opaque gray image in binary PPM format
+static void waitUntilLoaded(Canvas& canvas,
+                            const std::vector<AsyncImage>& images) {
+  for (int i = 0; i < 500; ++i) {
+    bool loading{false};
+
+    for (const auto& image : images) {
+      loading = loading || image.getStatus() == ImageStatus::LOADING;
+    }
+    if (!loading) {
+      return;
+    }
+    canvas.renderFrame();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+}
+
+TEST(ImageLoaderTest, loadsImagesInTheBackground) {
+  Canvas canvas(8, 8, headless);
+  const auto large{writeImageFile("dana_loader_large.ppm", 32, 16)};
+  const auto small{writeImageFile("dana_loader_small.ppm", 6, 4)};
+  std::vector<AsyncImage> images;
+
+  canvas.onNewFrame([&](Pencil&) {
+    if (!images.empty()) {
+      return;
+    }
+    auto& loader{canvas.getDevice().getImageLoader()};
+    ImageLoadOptions options;
+    options.max_width = 8;
+    options.premultiply = true;
+
+    images = {loader.createImageAsync(large, 0, options),
+              loader.createImageAsync(small, 0),
+              loader.createImageAsync(testing::TempDir() + "missing.png", 0)};
+
+    // Uploads only happen at the start of a frame, so the placeholder is
+    // drawn for now
+    ASSERT_FALSE(images[0].isReady());
+    ASSERT_EQ(images[0].getImage().getSize(), std::make_pair(1, 1));
+  });
+
+  canvas.renderFrame();
+  waitUntilLoaded(canvas, images);
+
+  ASSERT_EQ(images[0].getStatus(), ImageStatus::READY);
+  ASSERT_EQ(images[0].getImage().getSize(), std::make_pair(8, 4));
+  ASSERT_EQ(images[1].getStatus(), ImageStatus::READY);
+  ASSERT_EQ(images[1].getImage().getSize(), std::make_pair(6, 4));
+  ASSERT_EQ(images[2].getStatus(), ImageStatus::FAILED);
+  ASSERT_EQ(images[2].getImage().getSize(), std::make_pair(1, 1));
+}
+
+TEST(ImageLoaderTest, spreadsUploadsOverFrames) {
+  Canvas canvas(8, 8, headless);
+  const auto filename{writeImageFile("dana_loader_budget.ppm", 4, 4)};
+  std::vector<AsyncImage> images;
+
+  canvas.onNewFrame([&](Pencil&) {
+    if (!images.empty()) {
+      return;
+    }
+    auto& loader{canvas.getDevice().getImageLoader()};
+    loader.setUploadBudget(std::chrono::microseconds(0));
+
+    for (int i = 0; i < 4; ++i) {
+      images.push_back(loader.createImageAsync(filename, 0));
+    }
+  });
+
+  canvas.renderFrame();
+  canvas.getDevice().getThreadPool().wait();
+
+  for (std::size_t frame = 1; frame <= images.size(); ++frame) {
+    canvas.renderFrame();
+
+    std::size_t ready{0};
+
+    for (const auto& image : images) {
+      ready += image.isReady() ? 1 : 0;
+    }
+    // Without a budget, one image is uploaded per frame
+    ASSERT_EQ(ready, frame);
+  }
+}
+
+TEST(ImageLoaderTest, slowDecodesDoNotHoldUpParallelFrames) {
+  Canvas canvas(8, 8, headless);
+  const auto filename{writeImageFile("dana_loader_slow.ppm", 4, 4)};
+  auto& thread_pool{canvas.getDevice().getThreadPool()};
+  std::promise<void> release;
+  const auto released{release.get_future().share()};
+  std::atomic<int> chunks{0};
+
+  // Stands in for slow decodes occupying every worker, with a real decode
+  // queued behind them
+  for (std::size_t i = 0; i <= thread_pool.getThreadCount(); ++i) {
+    thread_pool.submit([released] { released.wait(); });
+  }
+  const auto image{
+      canvas.getDevice().getImageLoader().createImageAsync(filename, 0)};
+
+  // Releases the workers after the frame, or after a timeout, so a regression
+  // fails instead of hanging
+  std::promise<void> rendered;
+  std::thread releaser([&, done = rendered.get_future()] {
+    done.wait_for(std::chrono::seconds(5));
+    release.set_value();
+  });
+
+  canvas.onParallelFrame(4, [&](Picture&, std::size_t) { ++chunks; });
+
+  const auto start{std::chrono::steady_clock::now()};
+  canvas.renderFrame();
+  const auto elapsed{std::chrono::steady_clock::now() - start};
+
+  rendered.set_value();
+  releaser.join();
+  thread_pool.wait();
+
+  EXPECT_LT(elapsed, std::chrono::seconds(2));
+  EXPECT_EQ(chunks, 4);
+  EXPECT_NE(image.getStatus(), ImageStatus::FAILED);
+}
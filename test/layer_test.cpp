@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <dana/canvas.h>
+#include <dana/layer.h>
+
+#include "test_util.h"
+
+using namespace dana;
+
+TEST(LayerTest, rendersOnlyWhenInvalidated) {
+  Canvas canvas(16, 16, headless);
+  Color inside;
+  Color outside;
+
+  const auto layer{canvas.createLayer(8, 8)};
+  layer->onDraw([](Pencil& pencil) {
+    pencil.beginPath()
+        .rectangle(0, 0, 8, 8)
+        .setFillColor({255, 0, 0, 255})
+        .fill();
+  });
+  layer->setTransform({1, 0, 0, 1, 8, 8});
+
+  canvas.setClearColor({0, 0, 255, 255})
+      .onFrameReadback([&](const FramePixels& pixels) {
+        inside = getPixel(pixels, 12, 12);
+        outside = getPixel(pixels, 4, 4);
+      });
+
+  for (int i = 0; i < 3; ++i) {
+    canvas.renderFrame();
+  }
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(layer->getRenderCount(), 1u);
+  ASSERT_EQ(inside.r, 255);
+  ASSERT_EQ(inside.b, 0);
+  ASSERT_EQ(outside.r, 0);
+  ASSERT_EQ(outside.b, 255);
+
+  layer->invalidate();
+  canvas.renderFrame();
+
+  ASSERT_EQ(layer->getRenderCount(), 2u);
+}
+
+TEST(LayerTest, zOrderAndOpacity) {
+  Canvas canvas(4, 4, headless);
+  Color pixel;
+
+  const auto layer{canvas.createLayer(4, 4)};
+  layer->onDraw([](Pencil& pencil) {
+    pencil.beginPath()
+        .rectangle(0, 0, 4, 4)
+        .setFillColor({255, 255, 255, 255})
+        .fill();
+  });
+  canvas.setClearColor({0, 0, 0, 255})
+      .onNewFrame([](Pencil& pencil) {
+        pencil.beginPath()
+            .rectangle(0, 0, 2, 4)
+            .setFillColor({0, 255, 0, 255})
+            .fill();
+      })
+      .onFrameReadback(
+          [&](const FramePixels& pixels) { pixel = getPixel(pixels, 1, 1); });
+
+  // Above the draw callback by default
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(pixel.r, 255);
+
+  layer->setZOrder(-1);
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(pixel.r, 0);
+  ASSERT_EQ(pixel.g, 255);
+
+  layer->setZOrder(0).setOpacity(128);
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_NEAR(pixel.r, 128, 2);
+  ASSERT_EQ(layer->getRenderCount(), 1u);
+}
+
+TEST(LayerTest, reusesPooledFramebuffers) {
+  Canvas canvas(16, 16, headless);
+  auto& pool{canvas.getDevice().getFramebufferPool()};
+
+  const auto layer{canvas.createLayer(8, 8)};
+  canvas.renderFrame();
+  canvas.removeLayer(layer);
+
+  ASSERT_EQ(pool.getSize(), 1u);
+
+  const auto other_layer{canvas.createLayer(8, 8)};
+  canvas.renderFrame();
+
+  ASSERT_EQ(pool.getCreatedCount(), 1u);
+  ASSERT_EQ(pool.getReusedCount(), 1u);
+  ASSERT_EQ(pool.getSize(), 0u);
+}
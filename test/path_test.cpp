@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+
+#include <dana/canvas.h>
+#include <dana/path.h>
+
+#include "test_util.h"
+
+#include <vector>
+
+using namespace dana;
+
+TEST(PathTest, reusesGeometryWhenTranslated) {
+  Canvas canvas(32, 32, headless);
+  Path path;
+  path.circle(0, 0, 4);
+
+  Color inside;
+  Color outside;
+  float offset{8};
+
+  canvas.setClearColor({0, 0, 0, 255})
+      .onNewFrame([&](Pencil& pencil) {
+        pencil.translate(offset, offset)
+            .setFillColor({255, 0, 0, 255})
+            .fill(path);
+      })
+      .onFrameReadback([&](const FramePixels& pixels) {
+        inside = getPixel(pixels, static_cast<int>(offset),
+                          static_cast<int>(offset));
+        outside = getPixel(pixels, 2, 2);
+      });
+
+  for (int i = 0; i < 3; ++i) {
+    canvas.renderFrame();
+    canvas.flushReadbacks();
+
+    ASSERT_EQ(inside.r, 255);
+    ASSERT_EQ(outside.r, 0);
+    offset += 4;
+  }
+  ASSERT_EQ(path.getTessellationCount(), 1u);
+}
+
+TEST(PathTest, tessellatesPerScaleBucketAndStrokeStyle) {
+  Canvas canvas(32, 32, headless);
+  Path path;
+  path.moveTo(0, 0).lineTo(10, 10).bezierTo(12, 0, 16, 4, 20, 20);
+
+  float scale{1};
+  float stroke_width{1};
+
+  canvas.onNewFrame([&](Pencil& pencil) {
+    pencil.scale(scale, scale).setStrokeWidth(stroke_width).stroke(path);
+  });
+
+  canvas.renderFrame();
+  scale = 1.02f;
+  canvas.renderFrame();
+
+  ASSERT_EQ(path.getTessellationCount(), 1u);
+
+  scale = 2;
+  canvas.renderFrame();
+
+  ASSERT_EQ(path.getTessellationCount(), 2u);
+
+  stroke_width = 3;
+  canvas.renderFrame();
+
+  ASSERT_EQ(path.getTessellationCount(), 3u);
+  ASSERT_EQ(path.getCachedGeometryCount(), 3u);
+
+  path.lineTo(0, 20);
+
+  ASSERT_EQ(path.getCachedGeometryCount(), 0u);
+}
+
+TEST(PathTest, matchesImmediateDrawing) {
+  Canvas canvas(32, 32, headless);
+  Path path;
+  path.roundedRectangle(4, 4, 20, 12, 3).rectangle(8, 20, 10, 8);
+
+  bool retained{false};
+  std::vector<unsigned char> frames[2];
+
+  canvas.setClearColor({0, 0, 0, 255})
+      .onNewFrame([&](Pencil& pencil) {
+        pencil.rotate(0.1f).setFillColor({0, 255, 0, 255});
+
+        if (retained) {
+          pencil.fill(path);
+        } else {
+          pencil.beginPath()
+              .roundedRectangle(4, 4, 20, 12, 3)
+              .rectangle(8, 20, 10, 8)
+              .fill();
+        }
+      })
+      .onFrameReadback([&](const FramePixels& pixels) {
+        frames[retained ? 1 : 0].assign(
+            pixels.data, pixels.data + pixels.height * pixels.stride);
+      });
+
+  canvas.renderFrame();
+  retained = true;
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(frames[0], frames[1]);
+}
+
+TEST(PathTest, drawsInstancesLikeSeparateFills) {
+  Canvas canvas(32, 32, headless);
+  Path path;
+  path.circle(0, 0, 3);
+
+  const std::vector<TransformMatrix> transforms{{1, 0, 0, 1, 6, 6},
+                                                {1, 0, 0, 1, 20, 8},
+                                                {0, 1, -1, 0, 14, 22}};
+  const std::vector<Color> colors{
+      {255, 0, 0, 255}, {0, 255, 0, 255}, {0, 0, 255, 128}};
+
+  int frame{0};
+  std::size_t readbacks{0};
+  RenderStatistics statistics;
+  std::vector<unsigned char> frames[2];
+
+  canvas.setClearColor({0, 0, 0, 255})
+      .onNewFrame([&](Pencil& pencil) {
+        if (++frame == 3) {
+          statistics = pencil.getRenderStatistics();
+          return;
+        }
+        pencil.resetRenderStatistics().translate(1, 1).setFillColor(
+            {255, 255, 255, 255});
+
+        if (frame == 2) {
+          pencil.drawInstances(path, transforms, colors);
+          return;
+        }
+        for (std::size_t i = 0; i < transforms.size(); ++i) {
+          pencil.save()
+              .transform(transforms[i])
+              .setFillColor(colors[i])
+              .fill(path)
+              .restore();
+        }
+      })
+      .onFrameReadback([&](const FramePixels& pixels) {
+        if (readbacks < 2) {
+          frames[readbacks++].assign(
+              pixels.data, pixels.data + pixels.height * pixels.stride);
+        }
+      });
+
+  canvas.renderFrame();
+  canvas.renderFrame();
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(frames[0].size(), frames[1].size());
+
+  for (std::size_t i = 0; i < frames[0].size(); ++i) {
+    ASSERT_NEAR(frames[0][i], frames[1][i], 2) << "at byte " << i;
+  }
+  // Drawn by the GPU with one call, rather than one call per instance
+  ASSERT_EQ(statistics.instanced_calls, 1u);
+  ASSERT_EQ(statistics.calls, 1u);
+  ASSERT_EQ(path.getTessellationCount(), 1u);
+}
+
+TEST(PathTest, skipsInstancesWithoutColorForEach) {
+  Canvas canvas(32, 32, headless);
+  Path path;
+  path.circle(0, 0, 3);
+
+  const std::vector<TransformMatrix> transforms{{1, 0, 0, 1, 6, 6},
+                                                {1, 0, 0, 1, 20, 8},
+                                                {1, 0, 0, 1, 14, 22}};
+  const std::vector<Color> colors{{255, 0, 0, 255}, {0, 255, 0, 255}};
+
+  int frame{0};
+  RenderStatistics statistics;
+  Color center;
+
+  canvas.setClearColor({0, 0, 0, 255})
+      .onNewFrame([&](Pencil& pencil) {
+        if (++frame == 2) {
+          statistics = pencil.getRenderStatistics();
+          return;
+        }
+        pencil.resetRenderStatistics()
+            .setFillColor({255, 255, 255, 255})
+            .drawInstances(path, transforms, colors);
+      })
+      .onFrameReadback([&](const FramePixels& pixels) {
+        if (pixels.frame == 0) {
+          center = getPixel(pixels, 6, 6);
+        }
+      });
+
+  canvas.renderFrame();
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(statistics.calls, 0u);
+  ASSERT_EQ(center.r, 0);
+  ASSERT_EQ(center.g, 0);
+}
@@ -1,15 +1,20 @@
 #include <gtest/gtest.h>
 
 #include <dana/canvas.h>
+#include <dana/image_data.h>
 #include <dana/pencil.h>
 
+#include "test_util.h"
+
+#include <vector>
+
 using namespace dana;
 
 TEST(PencilTest, transform) {
   const TransformMatrix expected{1, 2, 3, 4, 5, 6};
 
   // Initialize OpenGL by instantiating a canvas
-  Canvas canvas(100, 100, "Pencil test");
+  Canvas canvas(100, 100, headless);
   Pencil pencil;
 
   pencil.transform(1, 2, 3, 4, 5, 6);
@@ -23,3 +28,225 @@ TEST(PencilTest, transform) {
   ASSERT_EQ(actual.horizontal_moving, expected.horizontal_moving);
   ASSERT_EQ(actual.vertical_moving, expected.vertical_moving);
 }
+
+TEST(PencilTest, bulkShapesMatchSingleShapes) {
+  Canvas canvas(32, 32, headless);
+
+  const std::vector<Rect> rects{{2, 2, 6, 4}, {10, 3, 5, 9}, {20, 20, 8, 2}};
+  const std::vector<Circle> circles{{8, 20, 3}, {24, 8, 4.5f}};
+  const std::vector<float> lines{2, 30, 30, 26, 16, 2, 16, 14};
+
+  bool bulk{false};
+  std::vector<unsigned char> frames[2];
+
+  canvas.setClearColor({0, 0, 0, 255})
+      .onNewFrame([&](Pencil& pencil) {
+        pencil.rotate(0.05f).setFillColor({255, 0, 0, 255}).beginPath();
+
+        if (bulk) {
+          pencil.rectangles(rects).circles(circles);
+        } else {
+          for (const auto& rect : rects) {
+            pencil.rectangle(rect.x, rect.y, rect.width, rect.height);
+          }
+          for (const auto& circle : circles) {
+            pencil.circle(circle.x, circle.y, circle.radius);
+          }
+        }
+        pencil.fill().setStrokeColor({0, 255, 0, 255}).beginPath();
+
+        if (bulk) {
+          pencil.lineSegments(lines);
+        } else {
+          for (std::size_t i = 0; i < lines.size(); i += 4) {
+            pencil.moveTo(lines[i], lines[i + 1])
+                .lineTo(lines[i + 2], lines[i + 3]);
+          }
+        }
+        pencil.stroke();
+      })
+      .onFrameReadback([&](const FramePixels& pixels) {
+        frames[bulk ? 1 : 0].assign(
+            pixels.data, pixels.data + pixels.height * pixels.stride);
+      });
+
+  canvas.renderFrame();
+  bulk = true;
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(frames[0].size(), frames[1].size());
+
+  for (std::size_t i = 0; i < frames[0].size(); ++i) {
+    ASSERT_NEAR(frames[0][i], frames[1][i], 1) << "at byte " << i;
+  }
+}
+
+TEST(PencilTest, streamsGeometryThroughRingBuffers) {
+  Canvas canvas(32, 32, headless);
+  int frame{0};
+  RenderStatistics statistics;
+  std::vector<Color> colors;
+
+  canvas.setClearColor({0, 0, 0, 255})
+      .onNewFrame([&](Pencil& pencil) {
+        if (frame == 0) {
+          pencil.setStreamBufferSize(4096).resetRenderStatistics();
+        }
+        // Each frame is drawn in its own color, so leftovers of earlier frames
+        // in the buffers would show
+        const unsigned char red = frame % 2 == 0 ? 255 : 0;
+        pencil.setFillColor({red, static_cast<unsigned char>(255 - red), 0,
+                             255})
+            .beginPath();
+
+        for (int i = 0; i < 4; ++i) {
+          pencil.circle(8 + (i % 2) * 16, 8 + (i / 2) * 16, 6);
+        }
+        // One frame does not fit in the buffers at all
+        for (int i = 0; frame == 5 && i < 200; ++i) {
+          pencil.circle(-100, -100, 20);
+        }
+        pencil.fill();
+        ++frame;
+      })
+      .onFrameReadback([&](const FramePixels& pixels) {
+        const auto* pixel{pixels.data + 24 * pixels.stride + 24 * 4};
+        colors.push_back({pixel[0], pixel[1], pixel[2], pixel[3]});
+      });
+
+  for (int i = 0; i < 10; ++i) {
+    canvas.renderFrame();
+  }
+  canvas.onNewFrame([&](Pencil& pencil) {
+    statistics = pencil.getRenderStatistics();
+  });
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_GE(statistics.flushes, 10u);
+  ASSERT_GT(statistics.stream_wraps, 0u);
+  ASSERT_GT(statistics.stream_orphans, 0u);
+  ASSERT_GE(colors.size(), 10u);
+
+  for (std::size_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(colors[i].r, i % 2 == 0 ? 255 : 0) << "frame " << i;
+    EXPECT_EQ(colors[i].g, i % 2 == 0 ? 0 : 255) << "frame " << i;
+  }
+}
+
+TEST(PencilTest, mergesCallsWithSharedState) {
+  Canvas canvas(32, 32, headless);
+  int frame{0};
+  RenderStatistics statistics;
+  std::vector<Color> colors;
+
+  canvas.setClearColor({0, 0, 0, 255})
+      .onNewFrame([&](Pencil& pencil) {
+        if (++frame == 2) {
+          statistics = pencil.getRenderStatistics();
+          return;
+        }
+        pencil.resetRenderStatistics().setFillColor({0, 255, 0, 255});
+
+        // Shapes of the same color are merged even when their transforms
+        // differ
+        for (int i = 0; i < 100; ++i) {
+          pencil.save()
+              .translate(i % 10 * 3, i / 10 * 3)
+              .beginPath()
+              .rectangle(0, 0, 2, 2)
+              .fill()
+              .restore();
+        }
+        // Another color breaks the run, and is drawn on top of it
+        pencil.setFillColor({255, 0, 0, 255})
+            .beginPath()
+            .rectangle(0, 0, 2, 2)
+            .fill();
+      })
+      .onFrameReadback([&](const FramePixels& pixels) {
+        if (colors.empty()) {
+          const auto* pixel{pixels.data + 31 * pixels.stride};
+          const auto* last{pixels.data + 4 * pixels.stride + 28 * 4};
+          colors = {{pixel[0], pixel[1], pixel[2], pixel[3]},
+                    {last[0], last[1], last[2], last[3]}};
+        }
+      });
+
+  canvas.renderFrame();
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(statistics.calls, 101u);
+  ASSERT_EQ(statistics.merged_calls, 99u);
+  ASSERT_LE(statistics.draw_calls, 4u);
+  ASSERT_EQ(colors.size(), 2u);
+  EXPECT_EQ(colors[0].r, 255);
+  EXPECT_EQ(colors[0].g, 0);
+  EXPECT_EQ(colors[1].r, 0);
+  EXPECT_EQ(colors[1].g, 255);
+}
+
+TEST(PencilTest, reordersCallsThatDoNotOverlap) {
+  Canvas canvas(32, 24, headless);
+  ImageData image_data(1, 1);
+  Image image;
+  int frame{0};
+  RenderStatistics statistics;
+  std::vector<Color> colors;
+
+  image_data.fill({0, 0, 1, 1}, {0, 0, 255, 255});
+
+  canvas.setClearColor({0, 0, 0, 255})
+      .onNewFrame([&](Pencil& pencil) {
+        if (++frame == 2) {
+          statistics = pencil.getRenderStatistics();
+          return;
+        }
+        pencil.setDrawCallReordering(true).resetRenderStatistics();
+        image = pencil.createImage(image_data, IMAGE_NEAREST);
+
+        const auto fillImage = [&](const float x, const float y) {
+          pencil.beginPath()
+              .rectangle(x, y, 3, 3)
+              .setFillPaint(pencil.createImagePattern(image, x, y, 3, 3, 0,
+                                                      255))
+              .fill();
+        };
+        // Alternating solid and image fills, which do not overlap
+        for (int i = 0; i < 8; ++i) {
+          pencil.setFillColor({0, 255, 0, 255})
+              .beginPath()
+              .rectangle(i * 4, 8, 3, 3)
+              .fill();
+          fillImage(i * 4, 16);
+        }
+        // Overlapping fills keep their order
+        fillImage(0, 0);
+        pencil.setFillColor({255, 0, 0, 255})
+            .beginPath()
+            .rectangle(0, 0, 3, 3)
+            .fill();
+      })
+      .onFrameReadback([&](const FramePixels& pixels) {
+        if (colors.empty()) {
+          colors = {getPixel(pixels, 1, 1), getPixel(pixels, 29, 9),
+                    getPixel(pixels, 29, 17)};
+        }
+      });
+
+  canvas.renderFrame();
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(statistics.calls, 18u);
+  ASSERT_EQ(statistics.submitted_state_changes, 16u);
+  ASSERT_EQ(statistics.state_changes, 2u);
+  ASSERT_EQ(colors.size(), 3u);
+  EXPECT_EQ(colors[0].r, 255);
+  EXPECT_EQ(colors[0].b, 0);
+  EXPECT_EQ(colors[1].g, 255);
+  EXPECT_EQ(colors[2].b, 255);
+  EXPECT_EQ(colors[2].g, 0);
+}
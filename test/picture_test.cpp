@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <dana/canvas.h>
+#include <dana/picture.h>
+
+#include <vector>
+
+using namespace dana;
+
+static Picture createPicture(const Path& path) {
+  Picture picture;
+  picture.save()
+      .translate(4, 4)
+      .setFillPaint(Paint{{1, 0, 0, 1, 0, 0},
+                          {0, 0},
+                          0,
+                          1,
+                          {255, 0, 0, 255},
+                          {255, 0, 0, 255},
+                          0})
+      .beginPath()
+      .roundedRectangle(0, 0, 12, 8, 2)
+      .fill()
+      .setStrokeColor({0, 0, 255, 255})
+      .setStrokeWidth(2)
+      .stroke(path)
+      .restore();
+  return picture;
+}
+
+TEST(PictureTest, countsCommands) {
+  Path path;
+  path.moveTo(0, 0).lineTo(10, 10);
+  auto picture{createPicture(path)};
+
+  ASSERT_EQ(picture.getCommandCount(), 10u);
+
+  const auto size{picture.getSize()};
+  picture.clear();
+
+  ASSERT_TRUE(picture.isEmpty());
+  ASSERT_EQ(picture.getSize(), 0u);
+
+  picture.circle(0, 0, 1);
+
+  ASSERT_EQ(picture.getCommandCount(), 1u);
+  ASSERT_LT(picture.getSize(), size);
+}
+
+TEST(PictureTest, replaysLikeDirectCalls) {
+  Canvas canvas(24, 24, headless);
+  Path path;
+  path.moveTo(0, 0).lineTo(10, 10).arc(10, 10, 4, 0, 3, Direction::CLOCKWISE);
+
+  const auto picture{createPicture(path)};
+  bool replay{false};
+  std::vector<unsigned char> frames[2];
+
+  canvas.setClearColor({0, 0, 0, 255})
+      .onNewFrame([&](Pencil& pencil) {
+        if (replay) {
+          picture.replay(pencil);
+          return;
+        }
+        pencil.save()
+            .translate(4, 4)
+            .setFillColor({255, 0, 0, 255})
+            .beginPath()
+            .roundedRectangle(0, 0, 12, 8, 2)
+            .fill()
+            .setStrokeColor({0, 0, 255, 255})
+            .setStrokeWidth(2)
+            .stroke(path)
+            .restore();
+      })
+      .onFrameReadback([&](const FramePixels& pixels) {
+        frames[replay ? 1 : 0].assign(
+            pixels.data, pixels.data + pixels.height * pixels.stride);
+      });
+
+  canvas.renderFrame();
+  replay = true;
+  canvas.renderFrame();
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(frames[0], frames[1]);
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <dana/redraw_scheduler.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace dana;
+using namespace std::chrono;
+
+TEST(RedrawSchedulerTest, onDemandWaitsForInvalidate) {
+  RedrawScheduler scheduler;
+  const RedrawScheduler::Clock::time_point start{};
+
+  ASSERT_TRUE(scheduler.isFrameDue(start));
+
+  scheduler.setRedrawMode(RedrawModes::ON_DEMAND);
+  scheduler.frameRendered(start);
+
+  ASSERT_FALSE(scheduler.isFrameDue(start + seconds{10}));
+  ASSERT_EQ(scheduler.getEventTimeout(start + seconds{10}), -1);
+
+  scheduler.invalidate();
+
+  ASSERT_TRUE(scheduler.isFrameDue(start + seconds{10}));
+  ASSERT_EQ(scheduler.getEventTimeout(start + seconds{10}), 0);
+
+  // Input events request a frame too
+  scheduler.frameRendered(start + seconds{10});
+  scheduler.handleInputEvent();
+
+  ASSERT_TRUE(scheduler.isFrameDue(start + seconds{10}));
+}
+
+TEST(RedrawSchedulerTest, redrawIntervalTriggersFrames) {
+  RedrawScheduler scheduler;
+  const RedrawScheduler::Clock::time_point start{};
+
+  scheduler.setRedrawMode(RedrawModes::ON_DEMAND);
+  scheduler.setRedrawInterval(milliseconds{100});
+  scheduler.frameRendered(start);
+
+  ASSERT_FALSE(scheduler.isFrameDue(start + milliseconds{40}));
+  ASSERT_EQ(scheduler.getEventTimeout(start + microseconds{40500}), 60);
+  ASSERT_TRUE(scheduler.isFrameDue(start + milliseconds{100}));
+  ASSERT_EQ(scheduler.getEventTimeout(start + milliseconds{100}), 0);
+}
+
+TEST(RedrawSchedulerTest, hiddenWindowsDoNotRender) {
+  RedrawScheduler scheduler;
+  const RedrawScheduler::Clock::time_point start{};
+
+  scheduler.setRedrawInterval(milliseconds{100});
+
+  for (const auto event : {WindowEvents::HIDDEN, WindowEvents::MINIMIZED}) {
+    ASSERT_FALSE(scheduler.handleWindowEvent(event));
+    ASSERT_FALSE(scheduler.isVisible());
+
+    // Neither continuous rendering, invalidation nor the interval renders
+    scheduler.invalidate();
+
+    ASSERT_FALSE(scheduler.isFrameDue(start + seconds{1}));
+    ASSERT_EQ(scheduler.getEventTimeout(start + seconds{1}), -1);
+
+    // Showing the window again redraws all of it
+    ASSERT_TRUE(scheduler.handleWindowEvent(event == WindowEvents::HIDDEN
+                                                ? WindowEvents::SHOWN
+                                                : WindowEvents::RESTORED));
+    ASSERT_TRUE(scheduler.isVisible());
+    ASSERT_TRUE(scheduler.isFrameDue(start + seconds{1}));
+  }
+  ASSERT_FALSE(scheduler.handleWindowEvent(WindowEvents::FOCUS_LOST));
+  ASSERT_TRUE(scheduler.isVisible());
+}
+
+TEST(RedrawSchedulerTest, invalidateWakesUpFromOtherThreads) {
+  std::atomic<int> wake_ups{0};
+  RedrawScheduler scheduler([&] { ++wake_ups; });
+  const RedrawScheduler::Clock::time_point start{};
+
+  scheduler.setRedrawMode(RedrawModes::ON_DEMAND);
+  scheduler.frameRendered(start);
+
+  std::thread other([&] { scheduler.invalidate(); });
+  other.join();
+
+  ASSERT_EQ(wake_ups, 1);
+  ASSERT_EQ(scheduler.getEventTimeout(start), 0);
+
+  // Events the loop is handling already do not wake it up
+  scheduler.frameRendered(start);
+  scheduler.handleInputEvent();
+
+  ASSERT_EQ(wake_ups, 1);
+
+  // Neither do frames the loop requests itself
+  scheduler.frameRendered(start);
+  scheduler.requestFrame();
+
+  ASSERT_EQ(wake_ups, 1);
+  ASSERT_TRUE(scheduler.isFrameDue(start));
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <dana/canvas.h>
+#include <dana/sprite_batch.h>
+
+#include "test_util.h"
+
+#include <string>
+#include <vector>
+
+using namespace dana;
+
+// A 2x2 image with a red, green, blue and white pixel, in binary PPM format
+static std::vector<unsigned char> createImageFile() {
+  const std::string header{"P6\n2 2\n255\n"};
+  std::vector<unsigned char> file(header.begin(), header.end());
+  file.insert(file.end(), {255, 0, 0, 0, 255, 0, 0, 0, 255, 255, 255, 255});
+  return file;
+}
+
+TEST(SpriteBatchTest, groupsSpritesByTint) {
+  const Image image;
+  SpriteBatch batch(image);
+
+  batch.add({0, 0, 1, 1}, Rect{0, 0, 4, 4})
+      .add({1, 0, 1, 1}, Rect{4, 0, 4, 4})
+      .add({0, 1, 1, 1}, Rect{0, 4, 4, 4}, {255, 255, 255, 128})
+      .add({1, 1, 1, 1}, Rect{4, 4, 4, 4});
+
+  ASSERT_EQ(batch.getSpriteCount(), 4u);
+  ASSERT_EQ(batch.getDrawCallCount(), 3u);
+
+  batch.clear();
+
+  ASSERT_TRUE(batch.isEmpty());
+  ASSERT_EQ(batch.getDrawCallCount(), 0u);
+}
+
+TEST(SpriteBatchTest, drawsImageParts) {
+  Canvas canvas(16, 16, headless);
+  auto file{createImageFile()};
+  Image image;
+  std::vector<Color> colors;
+
+  canvas.setClearColor({0, 0, 0, 255})
+      .onNewFrame([&](Pencil& pencil) {
+        // Images belong to the pencil of the canvas
+        image = pencil.createImage(file.data(), static_cast<int>(file.size()),
+                                   IMAGE_NEAREST);
+        SpriteBatch batch(image);
+        batch.add({0, 0, 1, 1}, Rect{0, 0, 8, 8})
+            .add({1, 0, 1, 1}, TransformMatrix{1, 0, 0, 1, 8, 0})
+            .add({0, 1, 1, 1}, TransformMatrix{-8, 0, 0, 8, 8, 8})
+            .add({1, 1, 1, 1}, Rect{8, 8, 8, 8}, {255, 255, 0, 255});
+
+        pencil.drawSprites(batch);
+      })
+      .onFrameReadback([&](const FramePixels& pixels) {
+        colors = {getPixel(pixels, 4, 4), getPixel(pixels, 8, 0),
+                  getPixel(pixels, 9, 1), getPixel(pixels, 4, 12),
+                  getPixel(pixels, 12, 12)};
+      });
+
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(colors.size(), 5u);
+
+  const std::vector<Color> expected{{255, 0, 0, 255},
+                                    {0, 255, 0, 255},
+                                    {0, 0, 0, 255},
+                                    {0, 0, 255, 255},
+                                    {255, 255, 0, 255}};
+
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(colors[i].r, expected[i].r) << "sprite " << i;
+    EXPECT_EQ(colors[i].g, expected[i].g) << "sprite " << i;
+    EXPECT_EQ(colors[i].b, expected[i].b) << "sprite " << i;
+  }
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <dana/spsc_queue.h>
+
+#include <thread>
+
+using namespace dana;
+
+TEST(SpscQueueTest, capacity) {
+  SpscQueue<int> queue(5);
+
+  ASSERT_EQ(queue.getCapacity(), 8u);
+  ASSERT_TRUE(queue.isEmpty());
+
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_TRUE(queue.tryPush(i));
+  }
+  ASSERT_FALSE(queue.tryPush(8));
+
+  int item{-1};
+
+  ASSERT_TRUE(queue.tryPop(item));
+  ASSERT_EQ(item, 0);
+  ASSERT_TRUE(queue.tryPush(8));
+}
+
+TEST(SpscQueueTest, keepsOrderAcrossThreads) {
+  constexpr int items{10000};
+  SpscQueue<int> queue(64);
+
+  std::thread producer([&] {
+    for (int i = 0; i < items; ++i) {
+      while (!queue.tryPush(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  int expected{0};
+  int out_of_order{0};
+
+  // Everything is popped before asserting, so the producer can finish and be
+  // joined when items come out of order
+  while (expected < items) {
+    int item{-1};
+
+    if (!queue.tryPop(item)) {
+      std::this_thread::yield();
+      continue;
+    }
+    out_of_order += item != expected ? 1 : 0;
+    ++expected;
+  }
+  producer.join();
+
+  ASSERT_EQ(out_of_order, 0);
+  ASSERT_TRUE(queue.isEmpty());
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <dana/readback.h>
+#include <dana/types.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace dana {
+
+/// Returns the color of a pixel in a frame read back from a canvas.
+inline Color getPixel(const FramePixels& pixels, const int x, const int y) {
+  // Rows are stored bottom to top
+  const auto* pixel{pixels.data + (pixels.height - 1 - y) * pixels.stride +
+                    x * 4};
+  return {pixel[0], pixel[1], pixel[2], pixel[3]};
+}
+
+/// Returns RGBA pixels of a given size filled with a single color.
+inline std::vector<unsigned char> createPixels(const int width,
+                                               const int height,
+                                               const Color& color) {
+  std::vector<unsigned char> pixels;
+
+  for (int i = 0; i < width * height; ++i) {
+    pixels.insert(pixels.end(), {color.r, color.g, color.b, color.a});
+  }
+  return pixels;
+}
+
+/// Writes a gray image in binary PPM format to the temporary directory and
+/// returns its path.
+inline std::string writeImageFile(const std::string& name, const int width = 4,
+                                  const int height = 4) {
+  const auto filename{testing::TempDir() + name};
+  std::ofstream file(filename, std::ios::binary);
+  file << "P6\n" << width << " " << height << "\n255\n";
+
+  const std::vector<char> pixels(width * height * 3, 100);
+  file.write(pixels.data(), static_cast<std::streamsize>(pixels.size()));
+  return filename;
+}
+}  // namespace dana
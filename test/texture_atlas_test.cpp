@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <dana/canvas.h>
+#include <dana/image_data.h>
+#include <dana/texture_atlas.h>
+
+#include "test_util.h"
+
+#include <vector>
+
+using namespace dana;
+
+static bool overlaps(const Rect& a, const Rect& b) {
+  return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height &&
+         b.y < a.y + a.height;
+}
+
+TEST(TextureAtlasTest, packsImagesIntoPages) {
+  Canvas canvas(8, 8, headless);
+
+  canvas.onNewFrame([&](Pencil& pencil) {
+    auto atlas{pencil.createTextureAtlas(64, 1)};
+    const auto pixels{createPixels(14, 10, {255, 0, 0, 255})};
+    std::vector<Image> images;
+
+    // 16x12 with the border, so 4 columns and 5 rows fit in a page
+    for (int i = 0; i < 20; ++i) {
+      images.push_back(atlas.add(14, 10, pixels.data()));
+    }
+    ASSERT_EQ(atlas.getPageCount(), 1u);
+
+    for (std::size_t i = 0; i < images.size(); ++i) {
+      ASSERT_TRUE(images[i].isSharedTexture());
+      ASSERT_EQ(images[i].getSize(), std::make_pair(14, 10));
+      ASSERT_EQ(images[i].getTextureSize(), std::make_pair(64, 64));
+
+      for (std::size_t j = 0; j < i; ++j) {
+        ASSERT_FALSE(overlaps(images[i].getRegion(), images[j].getRegion()));
+      }
+    }
+    images.push_back(atlas.add(14, 10, pixels.data()));
+
+    ASSERT_EQ(atlas.getPageCount(), 2u);
+    ASSERT_FALSE(atlas.add(64, 8, pixels.data()).getHandle());
+
+    // Pages without images are reused
+    images.clear();
+    atlas.add(14, 10, pixels.data());
+
+    ASSERT_EQ(atlas.getPageCount(), 2u);
+  });
+
+  canvas.renderFrame();
+}
+
+TEST(TextureAtlasTest, mapsPatternsAndSpritesToRegions) {
+  Canvas canvas(16, 8, headless);
+  Image first;
+  Image second;
+  std::vector<Color> colors;
+
+  canvas.setClearColor({0, 0, 0, 255})
+      .onNewFrame([&](Pencil& pencil) {
+        auto atlas{pencil.createTextureAtlas(32, 1)};
+        pencil.setTextureAtlas(&atlas);
+
+        const auto red{createPixels(4, 4, {255, 0, 0, 255})};
+        const auto green{createPixels(4, 4, {0, 255, 0, 255})};
+        // The images keep their page alive until the frame is drawn
+        first = pencil.createImage(4, 4, red.data(), 0);
+        second = pencil.createImage(4, 4, green.data(), 0);
+        pencil.setTextureAtlas(nullptr);
+
+        ASSERT_EQ(first.getHandle(), second.getHandle());
+
+        pencil.beginPath()
+            .rectangle(0, 0, 8, 8)
+            .setFillPaint(
+                pencil.createImagePattern(second, 0, 0, 8, 8, 0, 255))
+            .fill();
+
+        SpriteBatch batch(first);
+        batch.add({0, 0, 4, 4}, Rect{8, 0, 8, 8});
+        pencil.drawSprites(batch);
+      })
+      .onFrameReadback([&](const FramePixels& pixels) {
+        colors = {getPixel(pixels, 0, 0), getPixel(pixels, 7, 7),
+                  getPixel(pixels, 8, 0), getPixel(pixels, 15, 7)};
+      });
+
+  canvas.renderFrame();
+  canvas.flushReadbacks();
+
+  ASSERT_EQ(colors.size(), 4u);
+
+  for (std::size_t i = 0; i < colors.size(); ++i) {
+    const bool green{i < 2};
+    EXPECT_EQ(colors[i].r, green ? 0 : 255) << "pixel " << i;
+    EXPECT_EQ(colors[i].g, green ? 255 : 0) << "pixel " << i;
+  }
+}
+
+TEST(TextureAtlasTest, keepsImagesWithOtherFlagsOutOfTheAtlas) {
+  Canvas canvas(8, 8, headless);
+
+  canvas.onNewFrame([&](Pencil& pencil) {
+    auto atlas{pencil.createTextureAtlas(32, 1)};
+    pencil.setTextureAtlas(&atlas);
+
+    const auto pixels{createPixels(4, 4, {255, 0, 0, 255})};
+    ImageData image_data(4, 4);
+
+    // Pages are created with the flags of the atlas, which the images would
+    // lose there
+    ASSERT_TRUE(pencil.createImage(4, 4, pixels.data(), 0).isSharedTexture());
+    ASSERT_FALSE(pencil.createImage(4, 4, pixels.data(), IMAGE_REPEATX)
+                     .isSharedTexture());
+    ASSERT_FALSE(pencil.createImage(4, 4, pixels.data(), IMAGE_PREMULTIPLIED)
+                     .isSharedTexture());
+    ASSERT_FALSE(
+        pencil.createImage(image_data, IMAGE_NEAREST).isSharedTexture());
+
+    pencil.setTextureAtlas(nullptr);
+  });
+
+  canvas.renderFrame();
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <dana/thread_pool.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <vector>
+
+using namespace dana;
+
+TEST(ThreadPoolTest, parallelForCallsEachIndexOnce) {
+  ThreadPool pool(3);
+  std::vector<std::atomic<int>> calls(1000);
+
+  pool.parallelFor(calls.size(), [&](const std::size_t i) { ++calls[i]; });
+
+  for (const auto& count : calls) {
+    ASSERT_EQ(count, 1);
+  }
+}
+
+TEST(ThreadPoolTest, parallelForWithoutIndices) {
+  ThreadPool pool(3);
+  std::atomic<int> calls{0};
+
+  pool.parallelFor(0, [&](std::size_t) { ++calls; });
+  pool.wait();
+
+  ASSERT_EQ(calls, 0);
+}
+
+TEST(ThreadPoolTest, waitForSubmittedTasks) {
+  ThreadPool pool(2);
+  std::atomic<int> done{0};
+
+  for (int i = 0; i < 100; ++i) {
+    pool.submit([&] { ++done; });
+  }
+  pool.wait();
+
+  ASSERT_EQ(done, 100);
+  ASSERT_EQ(pool.getThreadCount(), 2u);
+}
+
+TEST(ThreadPoolTest, parallelForDoesNotWaitForQueuedTasks) {
+  ThreadPool pool(1);
+  std::promise<void> release;
+  const auto released{release.get_future().share()};
+
+  // Keeps the only worker busy, with another task queued behind it
+  pool.submit([released] { released.wait(); });
+  pool.submit([released] { released.wait(); });
+
+  auto loop{std::async(std::launch::async, [&] {
+    std::atomic<int> calls{0};
+    pool.parallelFor(8, [&](std::size_t) { ++calls; });
+    return calls.load();
+  })};
+  const auto status{loop.wait_for(std::chrono::seconds(5))};
+
+  release.set_value();
+  ASSERT_EQ(status, std::future_status::ready);
+  ASSERT_EQ(loop.get(), 8);
+  pool.wait();
+}
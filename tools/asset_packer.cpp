@@ -0,0 +1,65 @@
+#include <dana/asset_pack.h>
+
+#include <iostream>
+#include <string>
+
+using namespace dana;
+
+static void printUsage() {
+  std::cerr << "Usage: asset_packer [options] <output> <image>...\n"
+            << "\n"
+            << "Decodes images into an asset pack. Images are named by their\n"
+            << "path, or by a given name with name=path.\n"
+            << "\n"
+            << "Options:\n"
+            << "  --alpha        Pack a single channel per pixel\n"
+            << "  --no-mipmaps   Do not pack mip levels\n"
+            << "  --premultiply  Multiply colors by alpha\n";
+}
+
+int main(int argc, char* argv[]) {
+  AssetPackOptions options;
+  int arg{1};
+
+  for (; arg < argc && std::string(argv[arg]).rfind("--", 0) == 0; ++arg) {
+    const std::string option{argv[arg]};
+
+    if (option == "--alpha") {
+      options.format = PixelFormat::ALPHA;
+    } else if (option == "--no-mipmaps") {
+      options.mipmaps = false;
+    } else if (option == "--premultiply") {
+      options.premultiply = true;
+    } else {
+      printUsage();
+      return 1;
+    }
+  }
+  if (argc - arg < 2) {
+    printUsage();
+    return 1;
+  }
+  const std::string output{argv[arg++]};
+  AssetPackWriter writer;
+
+  for (; arg < argc; ++arg) {
+    const std::string image{argv[arg]};
+    const auto separator{image.find('=')};
+    const auto name{separator != std::string::npos ? image.substr(0, separator)
+                                                   : image};
+    const auto filename{
+        separator != std::string::npos ? image.substr(separator + 1) : image};
+
+    if (!writer.addImage(name, filename, options)) {
+      std::cerr << "Could not decode " << filename << "\n";
+      return 1;
+    }
+  }
+  if (!writer.write(output)) {
+    std::cerr << "Could not write " << output << "\n";
+    return 1;
+  }
+  std::cout << "Packed " << writer.getImageCount() << " images into "
+            << output << "\n";
+  return 0;
+}